@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    AnalyzerFifo.h
+    Wait-free audio-to-GUI sample FIFO for the spectrum analyzer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Single-producer/single-consumer FIFO of mono samples, built on
+    juce::AbstractFifo. The audio thread pushes and the GUI pulls.
+
+    Both sides only touch a pair of atomic positions and never wait for each
+    other. When the consumer falls behind, Push() drops whatever does not fit
+    rather than blocking, because the analyzer can afford to lose samples and
+    the audio thread cannot afford to wait. Only the constructor allocates.
+*/
+class AnalyzerFifo
+{
+public:
+    static constexpr int DefaultCapacity = 1 << 15;
+
+    explicit AnalyzerFifo(int capacity = DefaultCapacity) : Fifo(capacity), Buffer((size_t) capacity, 0.0f) {}
+
+    //==============================================================================
+    /** Producer side: mixes the block down to mono and appends it. */
+    void Push(const juce::dsp::AudioBlock<const float> &block) noexcept { PushBlock(block); }
+
+    /** The same for the double-precision path; the mix is rounded to float. */
+    void Push(const juce::dsp::AudioBlock<const double> &block) noexcept { PushBlock(block); }
+
+    //==============================================================================
+    /** Consumer side: copies up to maxSamples into destination and returns how many. */
+    int Pull(float *destination, int maxSamples) noexcept
+    {
+        int Start1, Size1, Start2, Size2;
+        Fifo.prepareToRead(maxSamples, Start1, Size1, Start2, Size2);
+
+        std::copy_n(Buffer.data() + Start1, Size1, destination);
+        std::copy_n(Buffer.data() + Start2, Size2, destination + Size1);
+
+        Fifo.finishedRead(Size1 + Size2);
+        return Size1 + Size2;
+    }
+
+    int GetNumReady() const noexcept { return Fifo.getNumReady(); }
+
+private:
+    template <typename SampleType>
+    void PushBlock(const juce::dsp::AudioBlock<const SampleType> &block) noexcept
+    {
+        auto NumChannels = block.getNumChannels();
+        if (NumChannels == 0)
+            return;
+
+        int Start1, Size1, Start2, Size2;
+        Fifo.prepareToWrite((int) block.getNumSamples(), Start1, Size1, Start2, Size2);
+
+        auto Gain = 1.0f / (float) NumChannels;
+        MixDown(block, 0, Buffer.data() + Start1, Size1, Gain);
+        MixDown(block, (size_t) Size1, Buffer.data() + Start2, Size2, Gain);
+
+        Fifo.finishedWrite(Size1 + Size2);
+        return;
+    }
+
+    static void MixDown(const juce::dsp::AudioBlock<const float> &block, size_t startSample, float *destination, int numSamples, float gain) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        juce::FloatVectorOperations::copyWithMultiply(destination, block.getChannelPointer(0) + startSample, gain, numSamples);
+
+        for (size_t Channel = 1; Channel < block.getNumChannels(); ++Channel)
+            juce::FloatVectorOperations::addWithMultiply(destination, block.getChannelPointer(Channel) + startSample, gain, numSamples);
+
+        return;
+    }
+
+    // FloatVectorOperations has no double-to-float mix, so this one sums in
+    // double and rounds once per sample.
+    static void MixDown(const juce::dsp::AudioBlock<const double> &block, size_t startSample, float *destination, int numSamples, float gain) noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto Sum = 0.0;
+
+            for (size_t Channel = 0; Channel < block.getNumChannels(); ++Channel)
+                Sum += block.getChannelPointer(Channel)[startSample + (size_t) n];
+
+            destination[n] = (float) (Sum * gain);
+        }
+        return;
+    }
+
+    juce::AbstractFifo Fifo;
+    std::vector<float> Buffer;
+
+    JUCE_DECLARE_NON_COPYABLE (AnalyzerFifo)
+};
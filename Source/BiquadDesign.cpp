@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    BiquadDesign.cpp
+    Allocation-free second-order section designs for the cascade.
+
+  ==============================================================================
+*/
+
+#include "BiquadDesign.h"
+
+template <typename FloatType>
+FloatType GetButterworthQ(int section, int order) noexcept
+{
+    // As FilterDesign computes it: in double, then rounded to FloatType.
+    return static_cast<FloatType>(1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0))));
+}
+
+static int GetNumCutSections(int order) noexcept
+{
+    jassert(order >= 2 && order <= 2 * ChainCoefficients::MaxCutStages && order % 2 == 0);
+    return juce::jlimit(1, ChainCoefficients::MaxCutStages, order / 2);
+}
+
+// Same expressions as IIR::Coefficients::makeLowPass(), with
+// n = 1 / tan(pi * frequency / sampleRate).
+template <typename FloatType>
+static BiquadCoefficients MakeLowPassSection(FloatType n, FloatType q) noexcept
+{
+    auto nSquared = n * n;
+    auto InvQ = (FloatType) 1 / q;
+    auto c1 = (FloatType) 1 / ((FloatType) 1 + InvQ * n + nSquared);
+
+    return { c1, c1 * (FloatType) 2, c1, c1 * (FloatType) 2 * ((FloatType) 1 - nSquared), c1 * ((FloatType) 1 - InvQ * n + nSquared) };
+}
+
+// Same expressions as IIR::Coefficients::makeHighPass(), with
+// n = tan(pi * frequency / sampleRate).
+template <typename FloatType>
+static BiquadCoefficients MakeHighPassSection(FloatType n, FloatType q) noexcept
+{
+    auto nSquared = n * n;
+    auto InvQ = (FloatType) 1 / q;
+    auto c1 = (FloatType) 1 / ((FloatType) 1 + InvQ * n + nSquared);
+
+    return { c1, c1 * (FloatType) -2, c1, c1 * (FloatType) 2 * (nSquared - (FloatType) 1), c1 * ((FloatType) 1 - InvQ * n + nSquared) };
+}
+
+template <typename FloatType>
+static FloatType GetPrewarpedFrequency(FloatType frequency, double sampleRate) noexcept
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0 && frequency <= sampleRate * 0.5);
+
+    return std::tan(juce::MathConstants<FloatType>::pi * frequency / static_cast<FloatType>(sampleRate));
+}
+
+// Divides through by a0, as the IIR::Coefficients constructor does.
+template <typename FloatType>
+static BiquadCoefficients Normalise(FloatType b0, FloatType b1, FloatType b2, FloatType a0, FloatType a1, FloatType a2) noexcept
+{
+    auto InvA0 = a0 != 0 ? (FloatType) 1 / a0 : (FloatType) 0;
+    return { b0 * InvA0, b1 * InvA0, b2 * InvA0, a1 * InvA0, a2 * InvA0 };
+}
+
+template <typename FloatType>
+int DesignButterworthLowPass(CutSections &sections, FloatType frequency, double sampleRate, int order) noexcept
+{
+    auto NumSections = GetNumCutSections(order);
+    auto n = (FloatType) 1 / GetPrewarpedFrequency(frequency, sampleRate);
+
+    for (int i = 0; i < NumSections; ++i)
+        sections[(size_t) i] = MakeLowPassSection(n, GetButterworthQ<FloatType>(i, order));
+
+    return NumSections;
+}
+
+template <typename FloatType>
+int DesignButterworthHighPass(CutSections &sections, FloatType frequency, double sampleRate, int order) noexcept
+{
+    auto NumSections = GetNumCutSections(order);
+    auto n = GetPrewarpedFrequency(frequency, sampleRate);
+
+    for (int i = 0; i < NumSections; ++i)
+        sections[(size_t) i] = MakeHighPassSection(n, GetButterworthQ<FloatType>(i, order));
+
+    return NumSections;
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignLowPass(double sampleRate, FloatType frequency, FloatType q) noexcept
+{
+    return MakeLowPassSection((FloatType) 1 / GetPrewarpedFrequency(frequency, sampleRate), q);
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignHighPass(double sampleRate, FloatType frequency, FloatType q) noexcept
+{
+    return MakeHighPassSection(GetPrewarpedFrequency(frequency, sampleRate), q);
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignPeak(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0);
+    jassert(q > 0 && gainFactor > 0);
+
+    // Same expressions as IIR::Coefficients::makePeakFilter(), including the
+    // division by a0 that the Coefficients constructor does.
+    auto A = juce::jmax((FloatType) 0, std::sqrt(gainFactor));
+    auto Omega = ((FloatType) 2 * juce::MathConstants<FloatType>::pi * juce::jmax(frequency, (FloatType) 2)) / static_cast<FloatType>(sampleRate);
+    auto Alpha = std::sin(Omega) / (q * (FloatType) 2);
+    auto c2 = (FloatType) -2 * std::cos(Omega);
+    auto AlphaTimesA = Alpha * A;
+    auto AlphaOverA = Alpha / A;
+
+    return Normalise((FloatType) 1 + AlphaTimesA, c2, (FloatType) 1 - AlphaTimesA, (FloatType) 1 + AlphaOverA, c2, (FloatType) 1 - AlphaOverA);
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignLowShelf(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0);
+    jassert(q > 0 && gainFactor > 0);
+
+    // Same expressions as IIR::Coefficients::makeLowShelf().
+    auto A = juce::jmax((FloatType) 0, std::sqrt(gainFactor));
+    auto AMinus1 = A - (FloatType) 1;
+    auto APlus1 = A + (FloatType) 1;
+    auto Omega = ((FloatType) 2 * juce::MathConstants<FloatType>::pi * juce::jmax(frequency, (FloatType) 2)) / static_cast<FloatType>(sampleRate);
+    auto CosOmega = std::cos(Omega);
+    auto Beta = std::sin(Omega) * std::sqrt(A) / q;
+    auto AMinus1TimesCos = AMinus1 * CosOmega;
+
+    return Normalise(A * (APlus1 - AMinus1TimesCos + Beta),
+                     A * (FloatType) 2 * (AMinus1 - APlus1 * CosOmega),
+                     A * (APlus1 - AMinus1TimesCos - Beta),
+                     APlus1 + AMinus1TimesCos + Beta,
+                     (FloatType) -2 * (AMinus1 + APlus1 * CosOmega),
+                     APlus1 + AMinus1TimesCos - Beta);
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignHighShelf(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept
+{
+    jassert(sampleRate > 0.0);
+    jassert(q > 0 && gainFactor > 0);
+
+    // Same expressions as IIR::Coefficients::makeHighShelf().
+    auto A = juce::jmax((FloatType) 0, std::sqrt(gainFactor));
+    auto AMinus1 = A - (FloatType) 1;
+    auto APlus1 = A + (FloatType) 1;
+    auto Omega = ((FloatType) 2 * juce::MathConstants<FloatType>::pi * juce::jmax(frequency, (FloatType) 2)) / static_cast<FloatType>(sampleRate);
+    auto CosOmega = std::cos(Omega);
+    auto Beta = std::sin(Omega) * std::sqrt(A) / q;
+    auto AMinus1TimesCos = AMinus1 * CosOmega;
+
+    return Normalise(A * (APlus1 + AMinus1TimesCos + Beta),
+                     A * (FloatType) -2 * (AMinus1 + APlus1 * CosOmega),
+                     A * (APlus1 + AMinus1TimesCos - Beta),
+                     APlus1 - AMinus1TimesCos + Beta,
+                     (FloatType) 2 * (AMinus1 - APlus1 * CosOmega),
+                     APlus1 - AMinus1TimesCos - Beta);
+}
+
+template <typename FloatType>
+BiquadCoefficients DesignNotch(double sampleRate, FloatType frequency, FloatType q) noexcept
+{
+    jassert(q > 0);
+
+    // Same expressions as IIR::Coefficients::makeNotch().
+    auto n = (FloatType) 1 / GetPrewarpedFrequency(frequency, sampleRate);
+    auto nSquared = n * n;
+    auto InvQ = (FloatType) 1 / q;
+    auto c1 = (FloatType) 1 / ((FloatType) 1 + n * InvQ + nSquared);
+    auto b0 = c1 * ((FloatType) 1 + nSquared);
+    auto b1 = (FloatType) 2 * c1 * ((FloatType) 1 - nSquared);
+
+    return { b0, b1, b0, b1, c1 * ((FloatType) 1 - n * InvQ + nSquared) };
+}
+
+//==============================================================================
+template float GetButterworthQ<float>(int, int) noexcept;
+template int DesignButterworthLowPass<float>(CutSections&, float, double, int) noexcept;
+template int DesignButterworthHighPass<float>(CutSections&, float, double, int) noexcept;
+template BiquadCoefficients DesignLowPass<float>(double, float, float) noexcept;
+template BiquadCoefficients DesignHighPass<float>(double, float, float) noexcept;
+template BiquadCoefficients DesignPeak<float>(double, float, float, float) noexcept;
+template BiquadCoefficients DesignLowShelf<float>(double, float, float, float) noexcept;
+template BiquadCoefficients DesignHighShelf<float>(double, float, float, float) noexcept;
+template BiquadCoefficients DesignNotch<float>(double, float, float) noexcept;
+
+template double GetButterworthQ<double>(int, int) noexcept;
+template int DesignButterworthLowPass<double>(CutSections&, double, double, int) noexcept;
+template int DesignButterworthHighPass<double>(CutSections&, double, double, int) noexcept;
+template BiquadCoefficients DesignLowPass<double>(double, double, double) noexcept;
+template BiquadCoefficients DesignHighPass<double>(double, double, double) noexcept;
+template BiquadCoefficients DesignPeak<double>(double, double, double, double) noexcept;
+template BiquadCoefficients DesignLowShelf<double>(double, double, double, double) noexcept;
+template BiquadCoefficients DesignHighShelf<double>(double, double, double, double) noexcept;
+template BiquadCoefficients DesignNotch<double>(double, double, double) noexcept;
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    BiquadDesign.h
+    Allocation-free second-order section designs for the cascade.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ChainCoefficients.h"
+
+// The Butterworth cuts, and the single sections the bands use, written
+// straight into fixed-size arrays.
+//
+// These use the same formulas as
+// juce::dsp::FilterDesign::designIIR*HighOrderButterworthMethod() and the
+// juce::dsp::IIR::Coefficients::make*() functions. Instantiated for float
+// they also use the same float arithmetic, so the sections match theirs;
+// the double versions feed the double-precision engine, where a steep low
+// cut far below the sample rate needs the extra bits. Unlike JUCE's,
+// nothing here touches the heap or takes a lock, so the coefficient ramps
+// can be designed on the audio thread. Both are instantiated in the .cpp.
+
+using CutSections = std::array<BiquadCoefficients, ChainCoefficients::MaxCutStages>;
+
+// Writes order / 2 sections for an even order from 2 to
+// 2 * ChainCoefficients::MaxCutStages, and returns how many were written.
+template <typename FloatType>
+int DesignButterworthLowPass(CutSections &sections, FloatType frequency, double sampleRate, int order) noexcept;
+
+template <typename FloatType>
+int DesignButterworthHighPass(CutSections &sections, FloatType frequency, double sampleRate, int order) noexcept;
+
+// Q of one section of an even-order Butterworth cascade. The SVF engine
+// uses the same values, so both topologies share the cut response.
+template <typename FloatType>
+FloatType GetButterworthQ(int section, int order) noexcept;
+
+template <typename FloatType> BiquadCoefficients DesignLowPass(double sampleRate, FloatType frequency, FloatType q) noexcept;
+template <typename FloatType> BiquadCoefficients DesignHighPass(double sampleRate, FloatType frequency, FloatType q) noexcept;
+template <typename FloatType> BiquadCoefficients DesignPeak(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept;
+template <typename FloatType> BiquadCoefficients DesignLowShelf(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept;
+template <typename FloatType> BiquadCoefficients DesignHighShelf(double sampleRate, FloatType frequency, FloatType q, FloatType gainFactor) noexcept;
+template <typename FloatType> BiquadCoefficients DesignNotch(double sampleRate, FloatType frequency, FloatType q) noexcept;
@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+    ChainCoefficients.cpp
+    Plain-data coefficient sets for the LowCut/Bell/HighCut cascade.
+
+  ==============================================================================
+*/
+
+#include "ChainCoefficients.h"
+#include "BiquadDesign.h"
+
+bool IsNeutralSection(const BiquadCoefficients &coefficients) noexcept
+{
+    // DesignPeak() at 0 dB computes b and a with the same expressions,
+    // so they match to the bit; the tolerance only absorbs rounding.
+    constexpr double Tolerance = 1.0e-7;
+
+    return std::abs(coefficients[0] - 1.0) <= Tolerance
+        && std::abs(coefficients[1] - coefficients[3]) <= Tolerance
+        && std::abs(coefficients[2] - coefficients[4]) <= Tolerance;
+}
+
+ChainSettings GetSideSettings(const ChainSettings &chainSettings) noexcept
+{
+    auto Side = chainSettings;
+    auto &MidSide = chainSettings.MidSide;
+
+    Side.BellFreq = MidSide.BellFreq;
+    Side.BellGainInDB = MidSide.BellGainInDB;
+    Side.BellQ = MidSide.BellQ;
+    Side.LowCutFreq = MidSide.LowCutFreq;
+    Side.HighCutFreq = MidSide.HighCutFreq;
+    Side.LowCutSlope = MidSide.LowCutSlope;
+    Side.HighCutSlope = MidSide.HighCutSlope;
+
+    Side.DynamicBell.Enabled = false;
+    Side.MidSide.Enabled = false;
+    return Side;
+}
+
+void DesignLowCutCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate)
+{
+    auto Order = 2 * (chainSettings.LowCutSlope + 1);
+
+    coefficients.NumLowCutStages = coefficients.DoublePrecision
+                                 ? DesignButterworthHighPass<double>(coefficients.LowCut, chainSettings.LowCutFreq, sampleRate, Order)
+                                 : DesignButterworthHighPass<float>(coefficients.LowCut, chainSettings.LowCutFreq, sampleRate, Order);
+    return;
+}
+
+void DesignHighCutCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate)
+{
+    auto Order = 2 * (chainSettings.HighCutSlope + 1);
+
+    coefficients.NumHighCutStages = coefficients.DoublePrecision
+                                  ? DesignButterworthLowPass<double>(coefficients.HighCut, chainSettings.HighCutFreq, sampleRate, Order)
+                                  : DesignButterworthLowPass<float>(coefficients.HighCut, chainSettings.HighCutFreq, sampleRate, Order);
+    return;
+}
+
+void DesignBellCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate)
+{
+    BandSettings Bell;
+    Bell.Type = BandType::Bell;
+    Bell.Freq = chainSettings.BellFreq;
+    Bell.GainInDB = chainSettings.BellGainInDB;
+    Bell.Q = chainSettings.BellQ;
+
+    coefficients.Bell = DesignBandSection(Bell, sampleRate, coefficients.DoublePrecision);
+    return;
+}
+
+template <typename FloatType>
+static BiquadCoefficients DesignBandSectionIn(const BandSettings &bandSettings, double sampleRate) noexcept
+{
+    auto Freq = (FloatType) bandSettings.Freq;
+    auto Q = (FloatType) bandSettings.Q;
+    auto GainFactor = juce::Decibels::decibelsToGain((FloatType) bandSettings.GainInDB);
+
+    switch (bandSettings.Type)
+    {
+        case BandType::Bell:        return DesignPeak(sampleRate, Freq, Q, GainFactor);
+        case BandType::LowShelf:    return DesignLowShelf(sampleRate, Freq, Q, GainFactor);
+        case BandType::HighShelf:   return DesignHighShelf(sampleRate, Freq, Q, GainFactor);
+        case BandType::Notch:       return DesignNotch(sampleRate, Freq, Q);
+        case BandType::LowCut:      return DesignHighPass(sampleRate, Freq, Q);
+        case BandType::HighCut:     return DesignLowPass(sampleRate, Freq, Q);
+        case BandType::Off:         break;
+    }
+
+    return { 1.0, 0.0, 0.0, 0.0, 0.0 };
+}
+
+BiquadCoefficients DesignBandSection(const BandSettings &bandSettings, double sampleRate, bool doublePrecision) noexcept
+{
+    return doublePrecision ? DesignBandSectionIn<double>(bandSettings, sampleRate)
+                           : DesignBandSectionIn<float>(bandSettings, sampleRate);
+}
+
+void DesignBandCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate)
+{
+    for (size_t Band = 0; Band < chainSettings.Bands.size(); ++Band)
+        coefficients.Bands[Band] = DesignBandSection(chainSettings.Bands[Band], sampleRate, coefficients.DoublePrecision);
+    return;
+}
+
+void DesignSideCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate)
+{
+    // Designed into a scratch set by the same functions as Mid's, so the
+    // ramps can call this on the audio thread too.
+    ChainCoefficients Side;
+    Side.DoublePrecision = coefficients.DoublePrecision;
+
+    auto SideSettings = GetSideSettings(chainSettings);
+    DesignLowCutCoefficients(Side, SideSettings, sampleRate);
+    DesignBellCoefficients(Side, SideSettings, sampleRate);
+    DesignHighCutCoefficients(Side, SideSettings, sampleRate);
+
+    coefficients.SideLowCut = Side.LowCut;
+    coefficients.SideHighCut = Side.HighCut;
+    coefficients.SideBell = Side.Bell;
+    coefficients.NumSideLowCutStages = Side.NumLowCutStages;
+    coefficients.NumSideHighCutStages = Side.NumHighCutStages;
+    return;
+}
+
+ChainCoefficients DesignChainCoefficients(const ChainSettings &chainSettings, double sampleRate, bool doublePrecision)
+{
+    ChainCoefficients Coefficients;
+    Coefficients.SampleRate = sampleRate;
+    Coefficients.Settings = chainSettings;
+    Coefficients.DoublePrecision = doublePrecision;
+
+    DesignLowCutCoefficients(Coefficients, chainSettings, sampleRate);
+    DesignBellCoefficients(Coefficients, chainSettings, sampleRate);
+    DesignBandCoefficients(Coefficients, chainSettings, sampleRate);
+    DesignHighCutCoefficients(Coefficients, chainSettings, sampleRate);
+
+    if (chainSettings.MidSide.Enabled)
+        DesignSideCoefficients(Coefficients, chainSettings, sampleRate);
+
+    return Coefficients;
+}
+
+void GetChainMagnitudes(const ChainCoefficients &coefficients, const double *frequencies, double *magnitudes, int numFrequencies)
+{
+    auto Count = (size_t) juce::jmax(0, numFrequencies);
+
+    // cos/sin of w and 2w, laid out as separate arrays so the per-section
+    // loop below is plain arithmetic over contiguous doubles, which the
+    // compiler vectorises. No std::complex and no trig inside the loop.
+    std::vector<double> Trig(Count * 4);
+    auto *Cos1 = Trig.data();
+    auto *Sin1 = Cos1 + Count;
+    auto *Cos2 = Sin1 + Count;
+    auto *Sin2 = Cos2 + Count;
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto w = juce::MathConstants<double>::twoPi * frequencies[i] / coefficients.SampleRate;
+        Cos1[i] = std::cos(w);
+        Sin1[i] = std::sin(w);
+        Cos2[i] = 2.0 * Cos1[i] * Cos1[i] - 1.0;
+        Sin2[i] = 2.0 * Sin1[i] * Cos1[i];
+        magnitudes[i] = 1.0;
+    }
+
+    // Accumulates |H|^2 of one section; the square root is taken once at the end.
+    auto ApplySection = [&](const BiquadCoefficients &section)
+    {
+        auto b0 = (double) section[0], b1 = (double) section[1], b2 = (double) section[2];
+        auto a1 = (double) section[3], a2 = (double) section[4];
+
+        for (size_t i = 0; i < Count; ++i)
+        {
+            auto NumeratorRe = b0 + b1 * Cos1[i] + b2 * Cos2[i];
+            auto NumeratorIm = b1 * Sin1[i] + b2 * Sin2[i];
+            auto DenominatorRe = 1.0 + a1 * Cos1[i] + a2 * Cos2[i];
+            auto DenominatorIm = a1 * Sin1[i] + a2 * Sin2[i];
+
+            magnitudes[i] *= (NumeratorRe * NumeratorRe + NumeratorIm * NumeratorIm)
+                           / (DenominatorRe * DenominatorRe + DenominatorIm * DenominatorIm);
+        }
+    };
+
+    ApplySection(coefficients.Bell);
+
+    for (auto &Band : coefficients.Bands)
+        if (! IsNeutralSection(Band))
+            ApplySection(Band);
+
+    for (int i = 0; i < coefficients.NumLowCutStages; ++i)
+        ApplySection(coefficients.LowCut[(size_t) i]);
+
+    for (int i = 0; i < coefficients.NumHighCutStages; ++i)
+        ApplySection(coefficients.HighCut[(size_t) i]);
+
+    for (size_t i = 0; i < Count; ++i)
+        magnitudes[i] = std::sqrt(magnitudes[i]);
+
+    return;
+}
+
+double GetChainTailSamples(const ChainCoefficients &coefficients, double decayInDB)
+{
+    auto LogTarget = std::log(juce::Decibels::decibelsToGain(-decayInDB, -1000.0));
+    auto TailSamples = 0.0;
+
+    // Each section rings for as long as its slowest pole takes to decay.
+    // Summing them over the cascade is a safe upper bound for the whole chain.
+    auto AddSection = [&](const BiquadCoefficients &section)
+    {
+        if (IsNeutralSection(section))
+            return;
+
+        auto a1 = (double) section[3], a2 = (double) section[4];
+        auto Discriminant = a1 * a1 - 4.0 * a2;
+        auto Radius = Discriminant < 0.0 ? std::sqrt(a2) : 0.5 * (std::abs(a1) + std::sqrt(Discriminant));
+
+        if (Radius >= 1.0)
+            TailSamples = std::numeric_limits<double>::infinity();
+        else if (Radius > 0.0)
+            TailSamples += LogTarget / std::log(Radius);
+    };
+
+    AddSection(coefficients.Bell);
+
+    for (auto &Band : coefficients.Bands)
+        AddSection(Band);
+
+    for (int i = 0; i < coefficients.NumLowCutStages; ++i)
+        AddSection(coefficients.LowCut[(size_t) i]);
+
+    for (int i = 0; i < coefficients.NumHighCutStages; ++i)
+        AddSection(coefficients.HighCut[(size_t) i]);
+
+    if (coefficients.Settings.MidSide.Enabled)
+    {
+        auto MidTailSamples = TailSamples;
+        TailSamples = 0.0;
+
+        AddSection(coefficients.SideBell);
+
+        for (auto &Band : coefficients.Bands)
+            AddSection(Band);
+
+        for (int i = 0; i < coefficients.NumSideLowCutStages; ++i)
+            AddSection(coefficients.SideLowCut[(size_t) i]);
+
+        for (int i = 0; i < coefficients.NumSideHighCutStages; ++i)
+            AddSection(coefficients.SideHighCut[(size_t) i]);
+
+        TailSamples = juce::jmax(MidTailSamples, TailSamples);
+    }
+
+    return TailSamples;
+}
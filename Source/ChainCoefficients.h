@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    ChainCoefficients.h
+    Plain-data coefficient sets for the LowCut/Bell/HighCut cascade.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum Slope
+{
+    Slope_12, Slope_24, Slope_36, Slope_48, Slope_60
+};
+
+// Number of extra bands after the fixed LowCut/Bell/HighCut. Each band adds
+// four generated parameters, so a build may set this lower or higher.
+#ifndef CHANNELEQ_NUM_BANDS
+ #define CHANNELEQ_NUM_BANDS 8
+#endif
+
+// The cuts are 12 dB/oct with a resonance set by Q. Off bands are not run.
+enum class BandType
+{
+    Off, Bell, LowShelf, HighShelf, Notch, LowCut, HighCut
+};
+
+struct BandSettings
+{
+    BandType Type {BandType::Off};
+    float Freq {1000}, GainInDB {0}, Q {0.7f};
+};
+
+// The Bell's dynamic mode. Above the threshold the bell's gain moves by
+// (1 / Ratio - 1) dB per dB of detected level: a ratio above 1 cuts the
+// band as it gets louder, a ratio below 1 boosts it.
+struct DynamicBellSettings
+{
+    bool Enabled {false}, ExternalSidechain {false};
+    float ThresholdInDB {-24}, Ratio {2}, AttackMs {10}, ReleaseMs {100};
+};
+
+// Mid/Side mode, for a stereo main bus. The LowCut, Bell and HighCut of
+// ChainSettings then filter Mid, (L + R) / 2, and these filter Side,
+// (L - R) / 2. The bands act on both alike; the dynamic Bell on Mid only.
+struct MidSideSettings
+{
+    bool Enabled {false};
+    float BellFreq {750}, BellGainInDB {0}, BellQ {0.7f};
+    float LowCutFreq {20}, HighCutFreq {20000};
+    Slope LowCutSlope {Slope::Slope_12}, HighCutSlope {Slope::Slope_12};
+};
+
+struct ChainSettings
+{
+    static constexpr int MaxBands = CHANNELEQ_NUM_BANDS;
+
+    float BellFreq {0}, BellGainInDB {0}, BellQ {0};
+    float LowCutFreq {0}, HighCutFreq {0};
+    Slope LowCutSlope {Slope::Slope_12}, HighCutSlope {Slope::Slope_12};
+
+    std::array<BandSettings, MaxBands> Bands {};
+
+    DynamicBellSettings DynamicBell;
+    MidSideSettings MidSide;
+};
+
+// The chain Side runs in Mid/Side mode: the Side filters with the shared
+// bands, and no dynamics or Mid/Side mode of its own.
+ChainSettings GetSideSettings(const ChainSettings &chainSettings) noexcept;
+
+// Which engine runs the cascade: direct-form biquads, or TPT state-variable
+// filters that can be retuned every few samples.
+enum class FilterTopology
+{
+    Biquad, SVF
+};
+
+// Normalised second-order section in the same layout juce::dsp::IIR::Coefficients
+// uses for its raw coefficients: b0, b1, b2, a1, a2 (a0 == 1). Stored as
+// double so one set can feed either engine; a float design is exact in it.
+using BiquadCoefficients = std::array<double, 5>;
+
+/**
+    A complete, allocation-free snapshot of the coefficients for one MonoChain.
+
+    These are designed off the audio thread and handed over by value, so the
+    realtime side only ever copies floats.
+*/
+struct ChainCoefficients
+{
+    static constexpr int MaxCutStages = 5;
+
+    std::array<BiquadCoefficients, MaxCutStages> LowCut {}, HighCut {};
+    BiquadCoefficients Bell {};
+
+    // One section per band; an Off band holds a pass-through section.
+    std::array<BiquadCoefficients, ChainSettings::MaxBands> Bands {};
+
+    int NumLowCutStages {0}, NumHighCutStages {0};
+
+    // Side's LowCut, Bell and HighCut, designed only when
+    // Settings.MidSide.Enabled; its bands are the ones above.
+    std::array<BiquadCoefficients, MaxCutStages> SideLowCut {}, SideHighCut {};
+    BiquadCoefficients SideBell {};
+    int NumSideLowCutStages {0}, NumSideHighCutStages {0};
+
+    double SampleRate {0};
+
+    // SampleRate is the host rate times 2^OversamplingOrder.
+    int OversamplingOrder {0};
+    FilterTopology Topology {FilterTopology::Biquad};
+
+    // Designed in double arithmetic for the double-precision engine. The
+    // float engine uses float designs, which match JUCE's to the bit. The
+    // ramps redesign in the same precision as the target.
+    bool DoublePrecision {false};
+
+    // The program change whose parameters these were designed from. The
+    // audio thread drops a set older than the program it has switched to.
+    int Generation {0};
+
+    // The settings these coefficients were designed from.
+    ChainSettings Settings;
+};
+
+// True for a section whose numerator matches its denominator, such as a
+// 0 dB bell: it passes the signal through unchanged.
+bool IsNeutralSection(const BiquadCoefficients &coefficients) noexcept;
+
+// These neither allocate nor lock, so the smoothing ramps can call them on
+// the audio thread. They design in coefficients.DoublePrecision.
+void DesignLowCutCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate);
+void DesignHighCutCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate);
+void DesignBellCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate);
+void DesignBandCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate);
+
+// Designs Side's LowCut, Bell and HighCut from chainSettings.MidSide.
+void DesignSideCoefficients(ChainCoefficients &coefficients, const ChainSettings &chainSettings, double sampleRate);
+
+BiquadCoefficients DesignBandSection(const BandSettings &bandSettings, double sampleRate, bool doublePrecision = false) noexcept;
+
+ChainCoefficients DesignChainCoefficients(const ChainSettings &chainSettings, double sampleRate, bool doublePrecision = false);
+
+// Magnitude of the whole LowCut/Bell/HighCut chain, or Mid's in Mid/Side
+// mode, at each of the given frequencies in Hz. Allocates scratch space, so
+// keep it off the audio thread.
+void GetChainMagnitudes(const ChainCoefficients &coefficients, const double *frequencies, double *magnitudes, int numFrequencies);
+
+// Samples until the chain's impulse response has decayed by decayInDB, at
+// coefficients.SampleRate, the longer of Mid's and Side's in Mid/Side mode.
+// Infinite if a pole sits on the unit circle.
+double GetChainTailSamples(const ChainCoefficients &coefficients, double decayInDB);
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    ChannelEQConsole.cpp
+    Batch processing of many ChannelEQ strips in one call.
+
+  ==============================================================================
+*/
+
+#include "ChannelEQConsole.h"
+
+// Same defaults as ChannelEQAudioProcessor::CreateParameterLayout().
+static ChainSettings GetDefaultStripSettings()
+{
+    ChainSettings Settings;
+    Settings.LowCutFreq = 20.0f;
+    Settings.HighCutFreq = 20000.0f;
+    Settings.BellFreq = 750.0f;
+    Settings.BellGainInDB = 0.0f;
+    Settings.BellQ = 0.7f;
+    return Settings;
+}
+
+void ChannelEQConsole::prepare(double sampleRate, int maximumBlockSize, int numStrips)
+{
+    jassert(numStrips >= 0);
+
+    const CheckedCriticalSection::ScopedLockType Lock(DesignLock);
+
+    SampleRate = sampleRate;
+    NumStrips = numStrips;
+
+    auto NumGroups = ((size_t) numStrips + NumLanes - 1) / NumLanes;
+    Groups.resize(NumGroups);
+
+    for (auto &Group : Groups)
+        Group.prepare(maximumBlockSize);
+
+    StripSettings.resize((size_t) numStrips, GetDefaultStripSettings());
+    PendingCoefficients.resize((size_t) numStrips);
+
+    for (size_t Strip = 0; Strip < (size_t) numStrips; ++Strip)
+    {
+        if (PendingCoefficients[Strip] == nullptr)
+            PendingCoefficients[Strip] = std::make_unique<TripleBuffer<ChainCoefficients>>();
+
+        // The sample rate may have changed; redesign from the stored settings.
+        PendingCoefficients[Strip]->Write(Cache->GetChainCoefficients(StripSettings[Strip], SampleRate));
+    }
+
+    ApplyPendingCoefficients();
+    return;
+}
+
+void ChannelEQConsole::setStripSettings(int strip, const ChainSettings &chainSettings)
+{
+    jassert(juce::isPositiveAndBelow(strip, NumStrips));
+
+    const CheckedCriticalSection::ScopedLockType Lock(DesignLock);
+
+    StripSettings[(size_t) strip] = chainSettings;
+    PendingCoefficients[(size_t) strip]->Write(Cache->GetChainCoefficients(chainSettings, SampleRate));
+    return;
+}
+
+void ChannelEQConsole::ApplyPendingCoefficients() noexcept
+{
+    for (size_t Strip = 0; Strip < (size_t) NumStrips; ++Strip)
+    {
+        auto &Pending = *PendingCoefficients[Strip];
+
+        if (Pending.Update())
+            Groups[Strip / NumLanes].setLaneCoefficients(Strip % NumLanes, Pending.GetReadBuffer());
+    }
+    return;
+}
+
+void ChannelEQConsole::process(juce::AudioBuffer<float> &strips) noexcept
+{
+    jassert(strips.getNumChannels() >= NumStrips);
+
+    juce::ScopedNoDenormals noDenormals;
+    ScopedRealtimeTrap RealtimeTrap;
+    ApplyPendingCoefficients();
+
+    juce::dsp::AudioBlock<float> Block(strips);
+
+    for (size_t Group = 0; Group < Groups.size(); ++Group)
+    {
+        auto FirstStrip = Group * NumLanes;
+        auto NumGroupStrips = juce::jmin(NumLanes, (size_t) NumStrips - FirstStrip);
+
+        Groups[Group].process(Block.getSubsetChannelBlock(FirstStrip, NumGroupStrips));
+    }
+    return;
+}
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    ChannelEQConsole.h
+    Batch processing of many ChannelEQ strips in one call.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+#include "SIMDFilterCascade.h"
+#include "TripleBuffer.h"
+#include "CoefficientCache.h"
+#include "RealtimeSafetyTrap.h"
+
+/**
+    Runs N mono channel strips, each with its own ChainSettings, through the
+    ChannelEQ cascade in one call.
+
+    Strips are packed NumLanes at a time into a SIMDFilterCascade with
+    per-lane coefficients, so a 64-channel console runs 16 SIMD cascades
+    instead of 64 scalar chains. A stereo strip is simply two adjacent strips
+    with the same settings.
+
+    setStripSettings() designs on the calling thread and hands the result to
+    process() through a lock-free triple buffer, the same way
+    ChannelEQAudioProcessor does. process() does not allocate.
+*/
+class ChannelEQConsole
+{
+public:
+    static constexpr size_t NumLanes = SIMDFilterCascade<float>::NumLanes;
+
+    ChannelEQConsole() = default;
+
+    /** Allocates the lane groups for numStrips strips. Not realtime safe. */
+    void prepare(double sampleRate, int maximumBlockSize, int numStrips);
+
+    int getNumStrips() const noexcept { return NumStrips; }
+
+    /** Designs the coefficients of one strip. Call from any thread but the
+        audio thread; concurrent callers are serialised, as the triple
+        buffers only allow one writer at a time.
+    */
+    void setStripSettings(int strip, const ChainSettings &chainSettings);
+
+    /** Filters every strip in place; channel i of the buffer is strip i. */
+    void process(juce::AudioBuffer<float> &strips) noexcept;
+
+private:
+    void ApplyPendingCoefficients() noexcept;
+
+    double SampleRate {0};
+    int NumStrips {0};
+
+    std::vector<SIMDFilterCascade<float>> Groups;
+    std::vector<std::unique_ptr<TripleBuffer<ChainCoefficients>>> PendingCoefficients;
+    std::vector<ChainSettings> StripSettings;
+
+    // Held by prepare() and setStripSettings() while they write StripSettings
+    // and the triple buffers. Never taken on the audio thread.
+    CheckedCriticalSection DesignLock;
+
+    juce::SharedResourcePointer<CoefficientCache> Cache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelEQConsole)
+};
@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.cpp
+    Process-wide LRU cache of designed filter coefficients.
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+// Quantisation grid, matching CreateParameterLayout().
+static int QuantiseFrequency(float frequency) { return juce::jlimit(1, 32767, juce::roundToInt(frequency)); }
+static int QuantiseQ(float q)                 { return juce::jlimit(1, 1023, juce::roundToInt(q * 20.0f)); }
+static int QuantiseGain(float gainInDB)       { return juce::jlimit(-127, 127, juce::roundToInt(gainInDB * 2.0f)); }
+static int QuantiseSampleRate(double rate)    { return juce::jlimit(1, (1 << 24) - 1, juce::roundToInt(rate)); }
+
+juce::uint64 CoefficientCache::MakeKey(FilterType type, int frequency, Slope slope, int qSteps, int gainSteps, int sampleRate, bool doublePrecision) noexcept
+{
+    return (juce::uint64) type
+         | (juce::uint64) slope << 3
+         | (juce::uint64) frequency << 6
+         | (juce::uint64) qSteps << 21
+         | (juce::uint64) (gainSteps + 128) << 31
+         | (juce::uint64) sampleRate << 39
+         | (juce::uint64) (doublePrecision ? 1 : 0) << 63;
+}
+
+//==============================================================================
+CoefficientCache::FilterCoefficientsPtr CoefficientCache::GetLowCut(float frequency, Slope slope, double sampleRate, bool doublePrecision)
+{
+    auto Frequency = QuantiseFrequency(frequency);
+    auto SampleRate = QuantiseSampleRate(sampleRate);
+
+    return GetOrDesign(MakeKey(FilterType::LowCut, Frequency, slope, 0, 0, SampleRate, doublePrecision), [&]
+    {
+        ChainSettings Settings;
+        Settings.LowCutFreq = (float) Frequency;
+        Settings.LowCutSlope = slope;
+
+        ChainCoefficients Designed;
+        Designed.DoublePrecision = doublePrecision;
+        DesignLowCutCoefficients(Designed, Settings, (double) SampleRate);
+
+        FilterCoefficients Result;
+        Result.Stages = Designed.LowCut;
+        Result.NumStages = Designed.NumLowCutStages;
+        return Result;
+    });
+}
+
+CoefficientCache::FilterCoefficientsPtr CoefficientCache::GetHighCut(float frequency, Slope slope, double sampleRate, bool doublePrecision)
+{
+    auto Frequency = QuantiseFrequency(frequency);
+    auto SampleRate = QuantiseSampleRate(sampleRate);
+
+    return GetOrDesign(MakeKey(FilterType::HighCut, Frequency, slope, 0, 0, SampleRate, doublePrecision), [&]
+    {
+        ChainSettings Settings;
+        Settings.HighCutFreq = (float) Frequency;
+        Settings.HighCutSlope = slope;
+
+        ChainCoefficients Designed;
+        Designed.DoublePrecision = doublePrecision;
+        DesignHighCutCoefficients(Designed, Settings, (double) SampleRate);
+
+        FilterCoefficients Result;
+        Result.Stages = Designed.HighCut;
+        Result.NumStages = Designed.NumHighCutStages;
+        return Result;
+    });
+}
+
+CoefficientCache::FilterCoefficientsPtr CoefficientCache::GetBell(float frequency, float q, float gainInDB, double sampleRate, bool doublePrecision)
+{
+    auto Frequency = QuantiseFrequency(frequency);
+    auto QSteps = QuantiseQ(q);
+    auto GainSteps = QuantiseGain(gainInDB);
+    auto SampleRate = QuantiseSampleRate(sampleRate);
+
+    return GetOrDesign(MakeKey(FilterType::Bell, Frequency, Slope_12, QSteps, GainSteps, SampleRate, doublePrecision), [&]
+    {
+        ChainSettings Settings;
+        Settings.BellFreq = (float) Frequency;
+        Settings.BellQ = (float) QSteps * 0.05f;
+        Settings.BellGainInDB = (float) GainSteps * 0.5f;
+
+        ChainCoefficients Designed;
+        Designed.DoublePrecision = doublePrecision;
+        DesignBellCoefficients(Designed, Settings, (double) SampleRate);
+
+        FilterCoefficients Result;
+        Result.Stages[0] = Designed.Bell;
+        Result.NumStages = 1;
+        return Result;
+    });
+}
+
+CoefficientCache::FilterCoefficientsPtr CoefficientCache::GetBand(const BandSettings &bandSettings, double sampleRate, bool doublePrecision)
+{
+    jassert(bandSettings.Type != BandType::Off);
+
+    if (bandSettings.Type == BandType::Bell)
+        return GetBell(bandSettings.Freq, bandSettings.Q, bandSettings.GainInDB, sampleRate, doublePrecision);
+
+    auto Type = FilterType::LowShelf;
+    auto HasGain = false;
+
+    switch (bandSettings.Type)
+    {
+        case BandType::LowShelf:    Type = FilterType::LowShelf; HasGain = true; break;
+        case BandType::HighShelf:   Type = FilterType::HighShelf; HasGain = true; break;
+        case BandType::Notch:       Type = FilterType::Notch; break;
+        case BandType::LowCut:      Type = FilterType::BandLowCut; break;
+        case BandType::HighCut:     Type = FilterType::BandHighCut; break;
+        case BandType::Off:
+        case BandType::Bell:        break;
+    }
+
+    auto Frequency = QuantiseFrequency(bandSettings.Freq);
+    auto QSteps = QuantiseQ(bandSettings.Q);
+    auto GainSteps = HasGain ? QuantiseGain(bandSettings.GainInDB) : 0;
+    auto SampleRate = QuantiseSampleRate(sampleRate);
+
+    return GetOrDesign(MakeKey(Type, Frequency, Slope_12, QSteps, GainSteps, SampleRate, doublePrecision), [&]
+    {
+        BandSettings Settings;
+        Settings.Type = bandSettings.Type;
+        Settings.Freq = (float) Frequency;
+        Settings.Q = (float) QSteps * 0.05f;
+        Settings.GainInDB = (float) GainSteps * 0.5f;
+
+        FilterCoefficients Result;
+        Result.Stages[0] = DesignBandSection(Settings, (double) SampleRate, doublePrecision);
+        Result.NumStages = 1;
+        return Result;
+    });
+}
+
+ChainCoefficients CoefficientCache::GetChainCoefficients(const ChainSettings &chainSettings, double sampleRate, bool doublePrecision)
+{
+    auto LowCut = GetLowCut(chainSettings.LowCutFreq, chainSettings.LowCutSlope, sampleRate, doublePrecision);
+    auto HighCut = GetHighCut(chainSettings.HighCutFreq, chainSettings.HighCutSlope, sampleRate, doublePrecision);
+    auto Bell = GetBell(chainSettings.BellFreq, chainSettings.BellQ, chainSettings.BellGainInDB, sampleRate, doublePrecision);
+
+    ChainCoefficients Coefficients;
+    Coefficients.SampleRate = sampleRate;
+    Coefficients.Settings = chainSettings;
+    Coefficients.DoublePrecision = doublePrecision;
+    Coefficients.LowCut = LowCut->Stages;
+    Coefficients.NumLowCutStages = LowCut->NumStages;
+    Coefficients.HighCut = HighCut->Stages;
+    Coefficients.NumHighCutStages = HighCut->NumStages;
+    Coefficients.Bell = Bell->Stages[0];
+
+    // Off bands are pass-through sections and never touch the cache.
+    for (size_t i = 0; i < chainSettings.Bands.size(); ++i)
+    {
+        auto &Band = chainSettings.Bands[i];
+        Coefficients.Bands[i] = Band.Type == BandType::Off ? DesignBandSection(Band, sampleRate, doublePrecision) : GetBand(Band, sampleRate, doublePrecision)->Stages[0];
+    }
+
+    if (chainSettings.MidSide.Enabled)
+    {
+        auto &Side = chainSettings.MidSide;
+        auto SideLowCut = GetLowCut(Side.LowCutFreq, Side.LowCutSlope, sampleRate, doublePrecision);
+        auto SideHighCut = GetHighCut(Side.HighCutFreq, Side.HighCutSlope, sampleRate, doublePrecision);
+
+        Coefficients.SideLowCut = SideLowCut->Stages;
+        Coefficients.NumSideLowCutStages = SideLowCut->NumStages;
+        Coefficients.SideHighCut = SideHighCut->Stages;
+        Coefficients.NumSideHighCutStages = SideHighCut->NumStages;
+        Coefficients.SideBell = GetBell(Side.BellFreq, Side.BellQ, Side.BellGainInDB, sampleRate, doublePrecision)->Stages[0];
+    }
+
+    return Coefficients;
+}
+
+//==============================================================================
+template <typename DesignFunction>
+CoefficientCache::FilterCoefficientsPtr CoefficientCache::GetOrDesign(juce::uint64 key, DesignFunction &&design)
+{
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(CacheLock);
+
+        auto Found = Index.find(key);
+        if (Found != Index.end())
+        {
+            Entries.splice(Entries.begin(), Entries, Found->second);
+            ++Hits;
+            return Found->second->Coefficients;
+        }
+    }
+
+    // Designed outside the lock, so that other instances are not kept waiting.
+    FilterCoefficientsPtr Designed = std::make_shared<FilterCoefficients>(design());
+    ++Misses;
+
+    const CheckedCriticalSection::ScopedLockType Lock(CacheLock);
+
+    // Another thread may have designed the same key in the meantime.
+    auto Found = Index.find(key);
+    if (Found != Index.end())
+    {
+        Entries.splice(Entries.begin(), Entries, Found->second);
+        return Found->second->Coefficients;
+    }
+
+    Entries.push_front({key, Designed});
+    Index[key] = Entries.begin();
+    TrimToCapacity();
+
+    return Designed;
+}
+
+void CoefficientCache::TrimToCapacity()
+{
+    while (Entries.size() > Capacity)
+    {
+        Index.erase(Entries.back().Key);
+        Entries.pop_back();
+        ++Evictions;
+    }
+    return;
+}
+
+//==============================================================================
+CoefficientCache::Statistics CoefficientCache::GetStatistics() const
+{
+    Statistics Result;
+    Result.Hits = Hits.load();
+    Result.Misses = Misses.load();
+    Result.Evictions = Evictions.load();
+
+    const CheckedCriticalSection::ScopedLockType Lock(CacheLock);
+    Result.Size = Entries.size();
+    Result.Capacity = Capacity;
+
+    return Result;
+}
+
+void CoefficientCache::SetCapacity(size_t newCapacity)
+{
+    const CheckedCriticalSection::ScopedLockType Lock(CacheLock);
+    Capacity = juce::jmax((size_t) 1, newCapacity);
+    TrimToCapacity();
+    return;
+}
+
+void CoefficientCache::Clear()
+{
+    const CheckedCriticalSection::ScopedLockType Lock(CacheLock);
+    Entries.clear();
+    Index.clear();
+    return;
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+    Process-wide LRU cache of designed filter coefficients.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+#include "RealtimeSafetyTrap.h"
+
+/**
+    A bounded, thread-safe cache of designed coefficients that every plugin
+    instance in the process shares through juce::SharedResourcePointer.
+
+    Settings are quantised on the grid that
+    ChannelEQAudioProcessor::CreateParameterLayout() defines: 1 Hz for
+    frequencies, 0.5 dB for gain and 0.05 for Q. The cache key is
+    (filter type, frequency, Q, gain, slope, sample rate, precision), and the
+    bands share it with the fixed filters. Float and double designs are
+    separate entries. Coefficients are
+    always designed from the quantised values, so a hit gives exactly the
+    same result as a miss.
+
+    Entries are immutable and shared. A hit only copies a shared_ptr and
+    moves a list node, so it does not allocate. The cache takes a lock, so it
+    must not be used on the audio thread.
+*/
+class CoefficientCache
+{
+public:
+    struct FilterCoefficients
+    {
+        std::array<BiquadCoefficients, ChainCoefficients::MaxCutStages> Stages {};
+        int NumStages {0};
+    };
+
+    using FilterCoefficientsPtr = std::shared_ptr<const FilterCoefficients>;
+
+    struct Statistics
+    {
+        juce::uint64 Hits {0}, Misses {0}, Evictions {0};
+        size_t Size {0}, Capacity {0};
+    };
+
+    static constexpr size_t DefaultCapacity = 2048;
+
+    CoefficientCache() = default;
+
+    //==============================================================================
+    FilterCoefficientsPtr GetLowCut(float frequency, Slope slope, double sampleRate, bool doublePrecision = false);
+    FilterCoefficientsPtr GetHighCut(float frequency, Slope slope, double sampleRate, bool doublePrecision = false);
+    FilterCoefficientsPtr GetBell(float frequency, float q, float gainInDB, double sampleRate, bool doublePrecision = false);
+
+    /** One section for a band that is not Off. A Bell band shares entries with the Bell. */
+    FilterCoefficientsPtr GetBand(const BandSettings &bandSettings, double sampleRate, bool doublePrecision = false);
+
+    /** Assembles a full coefficient set for one chain from cached filters. */
+    ChainCoefficients GetChainCoefficients(const ChainSettings &chainSettings, double sampleRate, bool doublePrecision = false);
+
+    //==============================================================================
+    Statistics GetStatistics() const;
+
+    void SetCapacity(size_t newCapacity);
+    void Clear();
+
+private:
+    enum class FilterType
+    {
+        LowCut, HighCut, Bell, LowShelf, HighShelf, Notch, BandLowCut, BandHighCut
+    };
+
+    struct Entry
+    {
+        juce::uint64 Key;
+        FilterCoefficientsPtr Coefficients;
+    };
+
+    static juce::uint64 MakeKey(FilterType type, int frequency, Slope slope, int qSteps, int gainSteps, int sampleRate, bool doublePrecision) noexcept;
+
+    template <typename DesignFunction>
+    FilterCoefficientsPtr GetOrDesign(juce::uint64 key, DesignFunction &&design);
+
+    void TrimToCapacity();
+
+    //==============================================================================
+    CheckedCriticalSection CacheLock;
+
+    // Most recently used at the front.
+    std::list<Entry> Entries;
+    std::unordered_map<juce::uint64, std::list<Entry>::iterator> Index;
+    size_t Capacity {DefaultCapacity};
+
+    std::atomic<juce::uint64> Hits {0}, Misses {0}, Evictions {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientCache)
+};
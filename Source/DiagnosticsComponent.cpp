@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DiagnosticsComponent.cpp
+    Editor panel showing the processor's PerformanceMonitor.
+
+  ==============================================================================
+*/
+
+#include "DiagnosticsComponent.h"
+
+#if CHANNELEQ_INSTRUMENTATION
+
+DiagnosticsComponent::DiagnosticsComponent(PerformanceMonitor &monitor) : Monitor(monitor)
+{
+    ResetButton.onClick = [this] { Monitor.Reset(); };
+    addAndMakeVisible(ResetButton);
+
+    setOpaque(true);
+    startTimerHz(RefreshRateHz);
+}
+
+DiagnosticsComponent::~DiagnosticsComponent()
+{
+}
+
+//==============================================================================
+void DiagnosticsComponent::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+
+    auto Bounds = getLocalBounds().reduced(6);
+    auto HistogramArea = Bounds.removeFromRight(Bounds.getWidth() / 3);
+    Bounds.removeFromRight(ResetButton.getWidth() + 6);
+
+    juce::String Lines;
+    Lines << "Load " << juce::String(Latest.AverageLoad * 100.0, 1) << "% avg, "
+          << juce::String(Latest.WorstLoad * 100.0, 1) << "% worst ("
+          << juce::String(Latest.WorstBlockSeconds * 1000.0, 2) << " ms)\n"
+          << "Overloads " << (juce::int64) Latest.Overloads << " of " << (juce::int64) Latest.Blocks << " blocks ("
+          << juce::String(Latest.GetOverloadRatio() * 100.0, 2) << "%)\n"
+          << "Designs " << (juce::int64) Latest.Designs << " (worst " << juce::String(Latest.WorstDesignSeconds * 1000.0, 2) << " ms), "
+          << "updates " << (juce::int64) Latest.CoefficientUpdates << ", ramp steps " << (juce::int64) Latest.RampUpdates << "\n"
+          << Latest.BlockSize << " samples at " << juce::String(Latest.SampleRate, 0) << " Hz ("
+          << (juce::int64) Latest.BlockSizeChanges << " size, " << (juce::int64) Latest.SampleRateChanges << " rate changes)";
+
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(12.0f);
+    g.drawFittedText(Lines, Bounds, juce::Justification::topLeft, 4);
+
+    // One bar per bucket, log-scaled so a handful of overloads still shows
+    // next to millions of quick blocks. The last bar is the overloads.
+    auto Peak = std::log1p((double) *std::max_element(Latest.Histogram.begin(), Latest.Histogram.end()));
+    auto BarWidth = (float) HistogramArea.getWidth() / (float) PerformanceMonitor::NumBuckets;
+
+    for (int Bucket = 0; Bucket < PerformanceMonitor::NumBuckets; ++Bucket)
+    {
+        auto Fraction = Peak > 0.0 ? std::log1p((double) Latest.Histogram[(size_t) Bucket]) / Peak : 0.0;
+        auto BarHeight = (float) Fraction * (float) HistogramArea.getHeight();
+
+        g.setColour(Bucket == PerformanceMonitor::NumBuckets - 1 ? juce::Colours::red : juce::Colours::skyblue);
+        g.fillRect((float) HistogramArea.getX() + (float) Bucket * BarWidth + 1.0f,
+                   (float) HistogramArea.getBottom() - BarHeight,
+                   BarWidth - 2.0f, BarHeight);
+    }
+    return;
+}
+
+void DiagnosticsComponent::resized()
+{
+    auto Bounds = getLocalBounds().reduced(6);
+    Bounds.removeFromRight(Bounds.getWidth() / 3 + 6);
+    ResetButton.setBounds(Bounds.removeFromRight(60).removeFromTop(24));
+    return;
+}
+
+//==============================================================================
+void DiagnosticsComponent::timerCallback()
+{
+    // Nothing moves while the host is stopped; leave an idle editor alone.
+    auto Snapshot = Monitor.GetSnapshot();
+    if (Snapshot == Latest)
+        return;
+
+    Latest = Snapshot;
+    repaint();
+    return;
+}
+
+#endif
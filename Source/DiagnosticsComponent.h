@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    DiagnosticsComponent.h
+    Editor panel showing the processor's PerformanceMonitor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceMonitor.h"
+
+#if CHANNELEQ_INSTRUMENTATION
+
+/**
+    Polls a PerformanceMonitor on the message thread and shows the load,
+    overloads, design and coefficient-update counts, the current block size
+    and sample rate, and the block-time histogram.
+
+    Only exists in builds with CHANNELEQ_INSTRUMENTATION set.
+*/
+class DiagnosticsComponent : public juce::Component,
+                             private juce::Timer
+{
+public:
+    explicit DiagnosticsComponent(PerformanceMonitor &monitor);
+    ~DiagnosticsComponent() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+    static constexpr int PreferredHeight = 90;
+    static constexpr int RefreshRateHz = 4;
+
+private:
+    void timerCallback() override;
+
+    PerformanceMonitor &Monitor;
+    PerformanceMonitor::Snapshot Latest;
+
+    juce::TextButton ResetButton {"Reset"};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsComponent)
+};
+
+#endif
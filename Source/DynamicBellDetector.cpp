@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    DynamicBellDetector.cpp
+    Band-limited envelope follower that drives the Bell's dynamic mode.
+
+  ==============================================================================
+*/
+
+#include "DynamicBellDetector.h"
+
+template <typename SampleType>
+void DynamicBellDetector<SampleType>::prepare(double sampleRate, int maximumBlockSize, int numChannels)
+{
+    SampleRate = sampleRate;
+    Groups.resize(((size_t) juce::jmax(1, numChannels) + NumLanes - 1) / NumLanes);
+    Scratch.resize((size_t) juce::jmax(1, maximumBlockSize));
+    reset();
+    return;
+}
+
+template <typename SampleType>
+void DynamicBellDetector<SampleType>::reset() noexcept
+{
+    for (auto &Group : Groups)
+        Group = { Vec::expand(0), Vec::expand(0), Vec::expand(0) };
+    return;
+}
+
+template <typename SampleType>
+void DynamicBellDetector<SampleType>::setParameters(float frequency, float q, float attackMs, float releaseMs) noexcept
+{
+    auto g = (SampleType) std::tan(juce::MathConstants<double>::pi * juce::jmin((double) frequency, 0.49 * SampleRate) / SampleRate);
+    k = (SampleType) 1 / (SampleType) q;
+
+    a1 = (SampleType) 1 / ((SampleType) 1 + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+
+    // One-pole coefficients that cover 1 - 1/e of a step in the given time.
+    auto GetBallistic = [this](float milliseconds)
+    {
+        return (SampleType) (1.0 - std::exp(-1.0 / (juce::jmax(0.01, (double) milliseconds) * 0.001 * SampleRate)));
+    };
+
+    Attack = GetBallistic(attackMs);
+    Release = GetBallistic(releaseMs);
+    return;
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType DynamicBellDetector<SampleType>::process(const juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+    jassert(! Scratch.empty());
+
+    auto NumChannels = juce::jmin(block.getNumChannels(), Groups.size() * NumLanes);
+    auto NumSamples = block.getNumSamples();
+
+    auto va1 = Vec::expand(a1), va2 = Vec::expand(a2), va3 = Vec::expand(a3), vk = Vec::expand(k);
+    auto vAttack = Vec::expand(Attack), vRelease = Vec::expand(Release);
+    auto Zero = Vec::expand(0);
+
+    auto Peak = (SampleType) 0;
+
+    for (size_t Group = 0; Group * NumLanes < NumChannels; ++Group)
+    {
+        auto &Lanes = Groups[Group];
+        auto ic1eq = Lanes.ic1eq, ic2eq = Lanes.ic2eq, Envelope = Lanes.Envelope;
+
+        for (size_t Start = 0; Start < NumSamples; Start += Scratch.size())
+        {
+            auto Count = juce::jmin(Scratch.size(), NumSamples - Start);
+
+            Interleave(block, Group * NumLanes, Start, Count);
+
+            for (size_t n = 0; n < Count; ++n)
+            {
+                auto v3 = Scratch[n] - ic2eq;
+                auto v1 = (va1 * ic1eq) + (va2 * v3);
+                auto v2 = ic2eq + (va2 * ic1eq) + (va3 * v3);
+                ic1eq = (v1 + v1) - ic1eq;
+                ic2eq = (v2 + v2) - ic2eq;
+
+                // k * v1 is the band pass with unity gain at the centre.
+                auto Difference = Vec::abs(vk * v1) - Envelope;
+                Envelope += (vAttack * Vec::max(Difference, Zero)) + (vRelease * Vec::min(Difference, Zero));
+            }
+        }
+
+        Lanes.ic1eq = ic1eq;
+        Lanes.ic2eq = ic2eq;
+        Lanes.Envelope = Envelope;
+
+        // Unused lanes only ever see silence, so they never win.
+        for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+            Peak = juce::jmax(Peak, Envelope.get(Lane));
+    }
+
+    return juce::Decibels::gainToDecibels(Peak, FloorInDB);
+}
+
+template <typename SampleType>
+void DynamicBellDetector<SampleType>::Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t firstChannel, size_t startSample, size_t numSamples) noexcept
+{
+    auto NumChannels = juce::jmin(NumLanes, block.getNumChannels() - firstChannel);
+    auto *Frames = reinterpret_cast<SampleType*>(Scratch.data());
+
+    for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+    {
+        if (Lane >= NumChannels)
+        {
+            for (size_t n = 0; n < numSamples; ++n)
+                Frames[n * NumLanes + Lane] = 0;
+
+            continue;
+        }
+
+        auto *Channel = block.getChannelPointer(firstChannel + Lane) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            Frames[n * NumLanes + Lane] = Channel[n];
+    }
+    return;
+}
+
+template class DynamicBellDetector<float>;
+template class DynamicBellDetector<double>;
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    DynamicBellDetector.h
+    Band-limited envelope follower that drives the Bell's dynamic mode.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Follows the level of the signal around the Bell's frequency, for the
+    Bell's dynamic mode.
+
+    Each channel is band-passed by a TPT state-variable filter at the Bell's
+    frequency and Q, normalised to unity gain at the centre, and rectified.
+    A peak follower with separate attack and release times smooths the
+    result. As in SVFFilterCascade, channels run one per SIMD lane. The
+    attack/release switch is a max/min pair rather than a branch, so all
+    lanes stay in step.
+
+    process() returns the loudest channel's level in dB, so every channel
+    gets the same gain change and the stereo image does not move. Only
+    prepare() allocates.
+*/
+template <typename SampleType>
+class DynamicBellDetector
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr size_t NumLanes = Vec::size();
+    static constexpr SampleType FloorInDB = -100;
+
+    //==============================================================================
+    /** Allocates state for numChannels channels and a block of up to
+        maximumBlockSize samples. Not realtime safe.
+    */
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+
+    /** Clears the band-pass state and drops every envelope to silence. */
+    void reset() noexcept;
+
+    /** Retunes the band-pass and the ballistics; keeps the state. */
+    void setParameters(float frequency, float q, float attackMs, float releaseMs) noexcept;
+
+    //==============================================================================
+    /** Runs the block through the detector and returns the envelope's level
+        at its end, in dB. Channels past those given to prepare() are ignored.
+    */
+    SampleType process(const juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+private:
+    //==============================================================================
+    struct State
+    {
+        Vec ic1eq, ic2eq, Envelope;
+    };
+
+    void Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t firstChannel, size_t startSample, size_t numSamples) noexcept;
+
+    //==============================================================================
+    std::vector<State> Groups;
+    std::vector<Vec> Scratch;
+
+    double SampleRate {44100.0};
+    SampleType a1 {0}, a2 {0}, a3 {0}, k {1};
+    SampleType Attack {1}, Release {1};
+
+    JUCE_LEAK_DETECTOR (DynamicBellDetector)
+};
@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+    LinearPhaseConvolver.cpp
+    Linear-phase FIR version of the chain, run by uniformly partitioned
+    FFT convolution.
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseConvolver.h"
+
+static int GetTransformOrder(int size)
+{
+    jassert(juce::isPowerOfTwo(size));
+    return juce::roundToInt(std::log2((double) size));
+}
+
+void DesignLinearPhaseKernel(LinearPhaseKernel &kernel, const ChainCoefficients &coefficients,
+                             double sampleRate, int kernelLength, int partitionSize)
+{
+    jassert(juce::isPowerOfTwo(kernelLength) && juce::isPowerOfTwo(partitionSize) && partitionSize <= kernelLength);
+
+    // Zero-phase impulse response: the sampled magnitude with no phase at all.
+    juce::dsp::FFT KernelTransform(GetTransformOrder(kernelLength));
+    std::vector<float> Buffer((size_t) kernelLength * 2, 0.0f);
+    auto *Bins = reinterpret_cast<std::complex<float>*>(Buffer.data());
+
+    auto NumMagnitudes = kernelLength / 2 + 1;
+    std::vector<double> Frequencies((size_t) NumMagnitudes), Magnitudes((size_t) NumMagnitudes);
+
+    for (int k = 0; k < NumMagnitudes; ++k)
+        Frequencies[(size_t) k] = k * sampleRate / kernelLength;
+
+    GetChainMagnitudes(coefficients, Frequencies.data(), Magnitudes.data(), NumMagnitudes);
+
+    for (int k = 0; k < NumMagnitudes; ++k)
+        Bins[k] = (float) Magnitudes[(size_t) k];
+
+    KernelTransform.performRealOnlyInverseTransform(Buffer.data());
+
+    // Centred on tap kernelLength / 2, which makes it causal and symmetric,
+    // then windowed with a periodic Blackman window around the same centre.
+    std::vector<float> Impulse((size_t) kernelLength);
+
+    for (int n = 0; n < kernelLength; ++n)
+    {
+        auto Phase = juce::MathConstants<double>::twoPi * n / kernelLength;
+        auto Window = 0.42 - 0.5 * std::cos(Phase) + 0.08 * std::cos(2.0 * Phase);
+
+        Impulse[(size_t) n] = Buffer[(size_t) ((n + kernelLength / 2) % kernelLength)] * (float) Window;
+    }
+
+    // Each partition, zero-padded to twice its length, is transformed once here.
+    auto NumPartitions = kernelLength / partitionSize;
+    auto NumBins = (size_t) partitionSize + 1;
+
+    juce::dsp::FFT PartitionTransform(GetTransformOrder(2 * partitionSize));
+    std::vector<float> Partition((size_t) partitionSize * 4);
+
+    kernel.Spectra.resize((size_t) NumPartitions * NumBins);
+    kernel.KernelLength = kernelLength;
+    kernel.PartitionSize = partitionSize;
+
+    for (int p = 0; p < NumPartitions; ++p)
+    {
+        std::fill(Partition.begin(), Partition.end(), 0.0f);
+        std::copy_n(Impulse.begin() + p * partitionSize, partitionSize, Partition.begin());
+
+        PartitionTransform.performRealOnlyForwardTransform(Partition.data(), true);
+
+        auto *PartitionBins = reinterpret_cast<const std::complex<float>*>(Partition.data());
+        std::copy_n(PartitionBins, NumBins, kernel.Spectra.begin() + (std::ptrdiff_t) (p * NumBins));
+    }
+    return;
+}
+
+//==============================================================================
+void LinearPhaseConvolver::prepare(int numChannels, int kernelLength, int partitionSize)
+{
+    jassert(juce::isPowerOfTwo(kernelLength) && juce::isPowerOfTwo(partitionSize));
+
+    NumChannels = juce::jmax(1, numChannels);
+    KernelLength = juce::jmin(kernelLength, MaximumKernelLength);
+    PartitionSize = juce::jlimit(MinimumPartitionSize, KernelLength, partitionSize);
+    NumPartitions = KernelLength / PartitionSize;
+    NumBins = PartitionSize + 1;
+
+    Transform = std::make_unique<juce::dsp::FFT>(GetTransformOrder(2 * PartitionSize));
+
+    auto Channels = (size_t) NumChannels;
+    auto Partition = (size_t) PartitionSize;
+    auto Spectrum = (size_t) NumBins;
+
+    InputFrames.assign(Channels * 2 * Partition, 0.0f);
+    OutputFrames.assign(Channels * Partition, 0.0f);
+    DelayLine.assign(Channels * (size_t) NumPartitions * Spectrum, {});
+
+    // Silent until the first setKernel().
+    for (auto &Kernel : Kernels)
+        Kernel.assign((size_t) NumPartitions * Spectrum, {});
+
+    CurrentKernel = 0;
+
+    // The real-only transforms work in place on twice the FFT size.
+    TransformBuffer.assign(4 * Partition, 0.0f);
+    CrossfadeBuffer.assign(Partition, 0.0f);
+    Accumulator.assign(Spectrum, {});
+
+    reset();
+    return;
+}
+
+void LinearPhaseConvolver::reset() noexcept
+{
+    std::fill(InputFrames.begin(), InputFrames.end(), 0.0f);
+    std::fill(OutputFrames.begin(), OutputFrames.end(), 0.0f);
+    std::fill(DelayLine.begin(), DelayLine.end(), std::complex<float>());
+
+    DelayLinePosition = 0;
+    Position = 0;
+    Crossfading = false;
+    return;
+}
+
+bool LinearPhaseConvolver::setKernel(const LinearPhaseKernel &kernel, bool crossfade) noexcept
+{
+    if (kernel.KernelLength != KernelLength || kernel.PartitionSize != PartitionSize
+        || kernel.Spectra.size() != Kernels[0].size())
+        return false;
+
+    auto Slot = crossfade ? 1 - CurrentKernel : CurrentKernel;
+    std::copy(kernel.Spectra.begin(), kernel.Spectra.end(), Kernels[(size_t) Slot].begin());
+
+    Crossfading = crossfade;
+    return true;
+}
+
+//==============================================================================
+void LinearPhaseConvolver::process(const juce::dsp::AudioBlock<float> &block) noexcept
+{
+    jassert(block.getNumChannels() <= (size_t) NumChannels);
+    jassert(Transform != nullptr);
+
+    auto NumBlockChannels = block.getNumChannels();
+    auto NumSamples = block.getNumSamples();
+
+    for (size_t Start = 0; Start < NumSamples;)
+    {
+        auto Count = juce::jmin((size_t) (PartitionSize - Position), NumSamples - Start);
+
+        // Samples go into the partition being filled; what comes out is the
+        // partition computed last time, which is where the extra
+        // PartitionSize samples of latency come from.
+        for (size_t Channel = 0; Channel < NumBlockChannels; ++Channel)
+        {
+            auto *Samples = block.getChannelPointer(Channel) + Start;
+            auto *Input = InputFrames.data() + Channel * 2 * (size_t) PartitionSize + (size_t) (PartitionSize + Position);
+            auto *Output = OutputFrames.data() + Channel * (size_t) PartitionSize + (size_t) Position;
+
+            juce::FloatVectorOperations::copy(Input, Samples, (int) Count);
+            juce::FloatVectorOperations::copy(Samples, Output, (int) Count);
+        }
+
+        Start += Count;
+        Position += (int) Count;
+
+        if (Position == PartitionSize)
+        {
+            ProcessPartition(NumBlockChannels);
+            Position = 0;
+        }
+    }
+    return;
+}
+
+void LinearPhaseConvolver::ProcessPartition(size_t numChannels) noexcept
+{
+    auto Partition = (size_t) PartitionSize;
+    auto Spectrum = (size_t) NumBins;
+
+    for (size_t Channel = 0; Channel < numChannels; ++Channel)
+    {
+        auto *Input = InputFrames.data() + Channel * 2 * Partition;
+        auto *Output = OutputFrames.data() + Channel * Partition;
+        auto *ChannelDelayLine = DelayLine.data() + Channel * (size_t) NumPartitions * Spectrum;
+
+        // The newest spectrum covers the previous and the current partition of input.
+        std::fill(TransformBuffer.begin(), TransformBuffer.end(), 0.0f);
+        std::copy_n(Input, 2 * Partition, TransformBuffer.begin());
+        Transform->performRealOnlyForwardTransform(TransformBuffer.data(), true);
+
+        auto *Bins = reinterpret_cast<const std::complex<float>*>(TransformBuffer.data());
+        std::copy_n(Bins, Spectrum, ChannelDelayLine + (size_t) DelayLinePosition * Spectrum);
+
+        std::copy_n(Input + Partition, Partition, Input);
+
+        for (int k = 0; k < (Crossfading ? 2 : 1); ++k)
+        {
+            auto &Kernel = Kernels[(size_t) (k == 0 ? CurrentKernel : 1 - CurrentKernel)];
+
+            std::fill(Accumulator.begin(), Accumulator.end(), std::complex<float>());
+
+            for (int p = 0; p < NumPartitions; ++p)
+            {
+                auto Slot = (DelayLinePosition - p + NumPartitions) % NumPartitions;
+                MultiplyAccumulate(Accumulator.data(), ChannelDelayLine + (size_t) Slot * Spectrum, Kernel.data() + (size_t) p * Spectrum);
+            }
+
+            InverseTransform(Accumulator.data());
+
+            // Overlap-save: the first half is circular wrap-around and is discarded.
+            if (k == 0)
+                std::copy_n(TransformBuffer.begin() + (std::ptrdiff_t) Partition, Partition, Output);
+            else
+                std::copy_n(TransformBuffer.begin() + (std::ptrdiff_t) Partition, Partition, CrossfadeBuffer.begin());
+        }
+
+        if (Crossfading)
+        {
+            for (size_t n = 0; n < Partition; ++n)
+            {
+                auto Fade = (float) (n + 1) / (float) Partition;
+                Output[n] += Fade * (CrossfadeBuffer[n] - Output[n]);
+            }
+        }
+    }
+
+    DelayLinePosition = (DelayLinePosition + 1) % NumPartitions;
+
+    if (Crossfading)
+    {
+        CurrentKernel = 1 - CurrentKernel;
+        Crossfading = false;
+    }
+    return;
+}
+
+void LinearPhaseConvolver::MultiplyAccumulate(std::complex<float> *accumulator, const std::complex<float> *delayLine,
+                                              const std::complex<float> *kernel) const noexcept
+{
+    // Written out on the real and imaginary parts, because std::complex
+    // multiplication checks for infinities and does not vectorise.
+    auto *Sum = reinterpret_cast<float*>(accumulator);
+    auto *X = reinterpret_cast<const float*>(delayLine);
+    auto *H = reinterpret_cast<const float*>(kernel);
+
+    for (int k = 0; k < 2 * NumBins; k += 2)
+    {
+        Sum[k]     += X[k] * H[k]     - X[k + 1] * H[k + 1];
+        Sum[k + 1] += X[k] * H[k + 1] + X[k + 1] * H[k];
+    }
+    return;
+}
+
+void LinearPhaseConvolver::InverseTransform(const std::complex<float> *spectrum) noexcept
+{
+    auto *Bins = reinterpret_cast<std::complex<float>*>(TransformBuffer.data());
+
+    std::copy_n(spectrum, NumBins, Bins);
+    std::fill(Bins + NumBins, Bins + 2 * PartitionSize, std::complex<float>());
+
+    Transform->performRealOnlyInverseTransform(TransformBuffer.data());
+    return;
+}
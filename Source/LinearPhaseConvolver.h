@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    LinearPhaseConvolver.h
+    Linear-phase FIR version of the chain, run by uniformly partitioned
+    FFT convolution.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+
+/**
+    A linear-phase FIR kernel in the partitioned frequency-domain form that
+    LinearPhaseConvolver consumes: KernelLength / PartitionSize spectra of
+    PartitionSize + 1 bins each.
+*/
+struct LinearPhaseKernel
+{
+    std::vector<std::complex<float>> Spectra;
+    int KernelLength {0}, PartitionSize {0};
+
+    // False when the processor is not in linear-phase mode; Spectra is then unused.
+    bool Enabled {false};
+};
+
+/** Samples the magnitude response of the chain and turns it into a windowed,
+    symmetric FIR of kernelLength taps, partitioned for the convolver. Both
+    sizes must be powers of two. Allocates, so call it off the audio thread.
+*/
+void DesignLinearPhaseKernel(LinearPhaseKernel &kernel, const ChainCoefficients &coefficients,
+                             double sampleRate, int kernelLength, int partitionSize);
+
+//==============================================================================
+/**
+    Uniformly partitioned overlap-save convolution (UPOLS) of every channel
+    with one shared kernel.
+
+    The input is gathered into blocks of PartitionSize samples. Each block is
+    transformed once into a frequency-domain delay line. The output is the sum
+    of that line multiplied by the kernel's partition spectra, so the cost per
+    sample grows with KernelLength / PartitionSize rather than KernelLength.
+    A larger partition means less CPU and more latency.
+
+    When a new kernel arrives, the next block is convolved with both kernels
+    and crossfaded, so parameter changes do not click.
+
+    Only prepare() allocates.
+*/
+class LinearPhaseConvolver
+{
+public:
+    static constexpr int MinimumPartitionSize = 64;
+    static constexpr int MaximumKernelLength = 32768;
+
+    LinearPhaseConvolver() = default;
+
+    /** Allocates every buffer for the given channel count and sizes. Not realtime safe. */
+    void prepare(int numChannels, int kernelLength, int partitionSize);
+
+    /** Clears the input history and the delay line. */
+    void reset() noexcept;
+
+    /** Copies in a new kernel, optionally crossfading from the current one
+        over the next partition. Returns false, and ignores the kernel, if it
+        was designed for different sizes than prepare() was given.
+    */
+    bool setKernel(const LinearPhaseKernel &kernel, bool crossfade) noexcept;
+
+    /** Convolves the block in place. It may have at most numChannels channels. */
+    void process(const juce::dsp::AudioBlock<float> &block) noexcept;
+
+    /** Half the kernel for the linear-phase delay, plus one partition of buffering. */
+    static int GetLatencySamples(int kernelLength, int partitionSize) noexcept { return partitionSize + kernelLength / 2; }
+
+    int getLatencySamples() const noexcept { return GetLatencySamples(KernelLength, PartitionSize); }
+
+private:
+    void ProcessPartition(size_t numChannels) noexcept;
+    void MultiplyAccumulate(std::complex<float> *accumulator, const std::complex<float> *delayLine, const std::complex<float> *kernel) const noexcept;
+    void InverseTransform(const std::complex<float> *spectrum) noexcept;
+
+    //==============================================================================
+    int NumChannels {0}, KernelLength {0}, PartitionSize {0}, NumPartitions {0}, NumBins {0};
+
+    std::unique_ptr<juce::dsp::FFT> Transform;
+
+    // Per channel: the last two partitions of input, and the output of the last partition.
+    std::vector<float> InputFrames, OutputFrames;
+
+    // Per channel: NumPartitions input spectra in a ring, newest at DelayLinePosition.
+    std::vector<std::complex<float>> DelayLine;
+    int DelayLinePosition {0};
+
+    // Two kernel slots, so the previous kernel is still there to crossfade from.
+    std::array<std::vector<std::complex<float>>, 2> Kernels;
+    int CurrentKernel {0};
+    bool Crossfading {false};
+
+    std::vector<float> TransformBuffer, CrossfadeBuffer;
+    std::vector<std::complex<float>> Accumulator;
+
+    // Position inside the partition currently being filled.
+    int Position {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseConvolver)
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.cpp
+    Lock-free per-instance timing and event counters for diagnosing dropouts.
+
+  ==============================================================================
+*/
+
+#include "PerformanceMonitor.h"
+
+#if CHANNELEQ_INSTRUMENTATION
+
+//==============================================================================
+/** Appends the monitor's snapshot to a file at a fixed interval. */
+class PerformanceMonitor::Logger : public juce::Thread
+{
+public:
+    Logger(const PerformanceMonitor &monitor, const juce::File &file, int intervalMs)
+        : juce::Thread("ChannelEQ Performance Log"), Monitor(monitor), LogFile(file), IntervalMs(juce::jmax(10, intervalMs))
+    {
+        startThread();
+    }
+
+    ~Logger() override
+    {
+        stopThread(IntervalMs + 1000);
+    }
+
+    void run() override
+    {
+        juce::FileOutputStream Stream(LogFile);
+
+        if (! Stream.openedOk())
+            return;
+
+        while (! threadShouldExit())
+        {
+            wait(IntervalMs);
+
+            Stream << ToJson(Monitor.GetSnapshot()) << "\n";
+            Stream.flush();
+        }
+        return;
+    }
+
+private:
+    const PerformanceMonitor &Monitor;
+    juce::File LogFile;
+    int IntervalMs;
+};
+
+//==============================================================================
+PerformanceMonitor::PerformanceMonitor()
+{
+}
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+    StopLogging();
+}
+
+void PerformanceMonitor::RecordBlock(juce::int64 ticks, int numSamples, double sampleRate) noexcept
+{
+    if (BlockResetRequested.exchange(false, std::memory_order_acquire))
+        ClearBlockCounters();
+
+    // The first block only sets the baseline.
+    auto LastBlockSize = BlockSize.load(std::memory_order_relaxed);
+
+    if (numSamples != LastBlockSize)
+    {
+        if (LastBlockSize != 0)
+            Increment(BlockSizeChanges);
+
+        BlockSize.store(numSamples, std::memory_order_relaxed);
+    }
+
+    auto LastSampleRate = SampleRate.load(std::memory_order_relaxed);
+
+    if (sampleRate != LastSampleRate)
+    {
+        if (LastSampleRate != 0.0)
+            Increment(SampleRateChanges);
+
+        SampleRate.store(sampleRate, std::memory_order_relaxed);
+    }
+
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    auto Seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+    auto DeadlineSeconds = numSamples / sampleRate;
+    auto Load = Seconds / DeadlineSeconds;
+
+    Increment(Blocks);
+    Accumulate(BusySeconds, Seconds);
+    Accumulate(AudioSeconds, DeadlineSeconds);
+    KeepMaximum(WorstLoad, Load);
+    KeepMaximum(WorstBlockSeconds, Seconds);
+
+    auto Bucket = std::upper_bound(BucketEdges.begin(), BucketEdges.end(), Load) - BucketEdges.begin();
+    Increment(Histogram[(size_t) Bucket]);
+
+    if (Load > 1.0)
+        Increment(Overloads);
+
+    return;
+}
+
+void PerformanceMonitor::RecordDesign(juce::int64 ticks) noexcept
+{
+    if (DesignResetRequested.exchange(false, std::memory_order_acquire))
+    {
+        Designs.store(0, std::memory_order_relaxed);
+        WorstDesignSeconds.store(0.0, std::memory_order_relaxed);
+    }
+
+    Increment(Designs);
+    KeepMaximum(WorstDesignSeconds, juce::Time::highResolutionTicksToSeconds(ticks));
+    return;
+}
+
+void PerformanceMonitor::ClearBlockCounters() noexcept
+{
+    for (auto *Counter : {&Blocks, &Overloads, &CoefficientUpdates, &RampUpdates, &BlockSizeChanges, &SampleRateChanges})
+        Counter->store(0, std::memory_order_relaxed);
+
+    for (auto &Count : Histogram)
+        Count.store(0, std::memory_order_relaxed);
+
+    for (auto *Value : {&BusySeconds, &AudioSeconds, &WorstLoad, &WorstBlockSeconds})
+        Value->store(0.0, std::memory_order_relaxed);
+
+    return;
+}
+
+//==============================================================================
+PerformanceMonitor::Snapshot PerformanceMonitor::GetSnapshot() const noexcept
+{
+    Snapshot Result;
+
+    Result.Blocks = Blocks.load(std::memory_order_relaxed);
+    Result.Overloads = Overloads.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < Histogram.size(); ++i)
+        Result.Histogram[i] = Histogram[i].load(std::memory_order_relaxed);
+
+    auto Audio = AudioSeconds.load(std::memory_order_relaxed);
+    Result.AverageLoad = Audio > 0.0 ? BusySeconds.load(std::memory_order_relaxed) / Audio : 0.0;
+    Result.WorstLoad = WorstLoad.load(std::memory_order_relaxed);
+    Result.WorstBlockSeconds = WorstBlockSeconds.load(std::memory_order_relaxed);
+
+    Result.Designs = Designs.load(std::memory_order_relaxed);
+    Result.CoefficientUpdates = CoefficientUpdates.load(std::memory_order_relaxed);
+    Result.RampUpdates = RampUpdates.load(std::memory_order_relaxed);
+    Result.WorstDesignSeconds = WorstDesignSeconds.load(std::memory_order_relaxed);
+
+    Result.BlockSize = BlockSize.load(std::memory_order_relaxed);
+    Result.SampleRate = SampleRate.load(std::memory_order_relaxed);
+    Result.BlockSizeChanges = BlockSizeChanges.load(std::memory_order_relaxed);
+    Result.SampleRateChanges = SampleRateChanges.load(std::memory_order_relaxed);
+    return Result;
+}
+
+void PerformanceMonitor::Reset() noexcept
+{
+    BlockResetRequested.store(true, std::memory_order_release);
+    DesignResetRequested.store(true, std::memory_order_release);
+    return;
+}
+
+//==============================================================================
+void PerformanceMonitor::StartLogging(const juce::File &file, int intervalMs)
+{
+    StopLogging();
+    ActiveLogger = std::make_unique<Logger>(*this, file, intervalMs);
+    return;
+}
+
+void PerformanceMonitor::StopLogging()
+{
+    ActiveLogger.reset();
+    return;
+}
+
+juce::String PerformanceMonitor::ToJson(const Snapshot &snapshot)
+{
+    juce::String Histogram;
+
+    for (auto Count : snapshot.Histogram)
+        Histogram << (Histogram.isEmpty() ? "" : ",") << (juce::int64) Count;
+
+    juce::String Line;
+    Line << "{\"time_ms\":" << juce::Time::currentTimeMillis()
+         << ",\"blocks\":" << (juce::int64) snapshot.Blocks
+         << ",\"overloads\":" << (juce::int64) snapshot.Overloads
+         << ",\"overload_ratio\":" << snapshot.GetOverloadRatio()
+         << ",\"average_load\":" << snapshot.AverageLoad
+         << ",\"worst_load\":" << snapshot.WorstLoad
+         << ",\"worst_block_ms\":" << snapshot.WorstBlockSeconds * 1000.0
+         << ",\"load_histogram\":[" << Histogram << "]"
+         << ",\"designs\":" << (juce::int64) snapshot.Designs
+         << ",\"worst_design_ms\":" << snapshot.WorstDesignSeconds * 1000.0
+         << ",\"coefficient_updates\":" << (juce::int64) snapshot.CoefficientUpdates
+         << ",\"ramp_updates\":" << (juce::int64) snapshot.RampUpdates
+         << ",\"block_size\":" << snapshot.BlockSize
+         << ",\"sample_rate\":" << snapshot.SampleRate
+         << ",\"block_size_changes\":" << (juce::int64) snapshot.BlockSizeChanges
+         << ",\"sample_rate_changes\":" << (juce::int64) snapshot.SampleRateChanges
+         << "}";
+    return Line;
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Lock-free per-instance timing and event counters for diagnosing dropouts.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// On by default in debug builds and compiled out otherwise. A release build
+// meant for diagnosing dropouts in the field can set it to 1.
+#ifndef CHANNELEQ_INSTRUMENTATION
+ #if JUCE_DEBUG
+  #define CHANNELEQ_INSTRUMENTATION 1
+ #else
+  #define CHANNELEQ_INSTRUMENTATION 0
+ #endif
+#endif
+
+/**
+    Block timings and event counts for one processor.
+
+    Each counter has a single writer. processBlock() owns the block timings,
+    the coefficient updates and the block-size and sample-rate changes.
+    UpdateFilters() owns the designs, under the processor's design lock.
+    Writers update the counters with relaxed loads and stores, with no
+    read-modify-write and no fences. A block therefore costs two clock reads
+    and a dozen stores.
+    GetSnapshot() may be called from any thread. It can mix the counters of
+    two neighbouring blocks, but never tears a single value.
+
+    With CHANNELEQ_INSTRUMENTATION set to 0, every member function is an
+    empty inline and the class holds no data.
+*/
+class PerformanceMonitor
+{
+public:
+    // Upper edges of the block-time histogram, as a fraction of the block's
+    // deadline: its duration at the host rate. The last bucket holds the
+    // blocks that missed it.
+    static constexpr int NumBuckets = 8;
+    static constexpr std::array<double, NumBuckets - 1> BucketEdges {0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0};
+
+    struct Snapshot
+    {
+        juce::uint64 Blocks {0}, Overloads {0};
+        std::array<juce::uint64, NumBuckets> Histogram {};
+
+        // Time spent in processBlock over the duration of the audio it
+        // produced, on average and for the worst block.
+        double AverageLoad {0}, WorstLoad {0}, WorstBlockSeconds {0};
+
+        // Designs published by UpdateFilters(); coefficient sets picked up
+        // by the audio thread; smoothing steps redesigned on it.
+        juce::uint64 Designs {0}, CoefficientUpdates {0}, RampUpdates {0};
+        double WorstDesignSeconds {0};
+
+        int BlockSize {0};
+        double SampleRate {0};
+        juce::uint64 BlockSizeChanges {0}, SampleRateChanges {0};
+
+        /** The fraction of blocks that took longer than their deadline. */
+        double GetOverloadRatio() const noexcept { return Blocks > 0 ? (double) Overloads / (double) Blocks : 0.0; }
+
+        bool operator== (const Snapshot &other) const noexcept
+        {
+            return Blocks == other.Blocks && Overloads == other.Overloads && Histogram == other.Histogram
+                && AverageLoad == other.AverageLoad && WorstLoad == other.WorstLoad && WorstBlockSeconds == other.WorstBlockSeconds
+                && Designs == other.Designs && CoefficientUpdates == other.CoefficientUpdates && RampUpdates == other.RampUpdates
+                && WorstDesignSeconds == other.WorstDesignSeconds && BlockSize == other.BlockSize && SampleRate == other.SampleRate
+                && BlockSizeChanges == other.BlockSizeChanges && SampleRateChanges == other.SampleRateChanges;
+        }
+    };
+
+   #if CHANNELEQ_INSTRUMENTATION
+    PerformanceMonitor();
+    ~PerformanceMonitor();
+
+    /** Times one processBlock() call, from construction to destruction. */
+    class ScopedBlockTimer
+    {
+    public:
+        ScopedBlockTimer(PerformanceMonitor &monitor, int numSamples, double sampleRate) noexcept
+            : Monitor(monitor), NumSamples(numSamples), SampleRate(sampleRate), Start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedBlockTimer() noexcept { Monitor.RecordBlock(juce::Time::getHighResolutionTicks() - Start, NumSamples, SampleRate); }
+
+    private:
+        PerformanceMonitor &Monitor;
+        int NumSamples;
+        double SampleRate;
+        juce::int64 Start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlockTimer)
+    };
+
+    /** Times one design in UpdateFilters(). */
+    class ScopedDesignTimer
+    {
+    public:
+        explicit ScopedDesignTimer(PerformanceMonitor &monitor) noexcept
+            : Monitor(monitor), Start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedDesignTimer() noexcept { Monitor.RecordDesign(juce::Time::getHighResolutionTicks() - Start); }
+
+    private:
+        PerformanceMonitor &Monitor;
+        juce::int64 Start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedDesignTimer)
+    };
+
+    void RecordCoefficientUpdate() noexcept { Increment(CoefficientUpdates); }
+    void RecordRampUpdate() noexcept        { Increment(RampUpdates); }
+
+    Snapshot GetSnapshot() const noexcept;
+
+    /** Clears every counter. Each writer clears its own at its next record. */
+    void Reset() noexcept;
+
+    /** Appends a snapshot to file every intervalMs, as one JSON object per
+        line, from a background thread. Replaces any log already running.
+        Call these from one thread only, normally the message thread.
+    */
+    void StartLogging(const juce::File &file, int intervalMs = 1000);
+    void StopLogging();
+
+    static juce::String ToJson(const Snapshot &snapshot);
+
+private:
+    class Logger;
+
+    void RecordBlock(juce::int64 ticks, int numSamples, double sampleRate) noexcept;
+    void RecordDesign(juce::int64 ticks) noexcept;
+    void ClearBlockCounters() noexcept;
+
+    // Only the counter's own writer may call these.
+    static void Increment(std::atomic<juce::uint64> &counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static void Accumulate(std::atomic<double> &total, double value) noexcept
+    {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void KeepMaximum(std::atomic<double> &maximum, double value) noexcept
+    {
+        if (value > maximum.load(std::memory_order_relaxed))
+            maximum.store(value, std::memory_order_relaxed);
+    }
+
+    std::atomic<juce::uint64> Blocks {0}, Overloads {0};
+    std::array<std::atomic<juce::uint64>, NumBuckets> Histogram {};
+    std::atomic<double> BusySeconds {0}, AudioSeconds {0}, WorstLoad {0}, WorstBlockSeconds {0};
+
+    std::atomic<juce::uint64> Designs {0}, CoefficientUpdates {0}, RampUpdates {0};
+    std::atomic<double> WorstDesignSeconds {0};
+
+    std::atomic<int> BlockSize {0};
+    std::atomic<double> SampleRate {0};
+    std::atomic<juce::uint64> BlockSizeChanges {0}, SampleRateChanges {0};
+
+    std::atomic<bool> BlockResetRequested {false}, DesignResetRequested {false};
+
+    std::unique_ptr<Logger> ActiveLogger;
+   #else
+    class ScopedBlockTimer
+    {
+    public:
+        ScopedBlockTimer(PerformanceMonitor&, int, double) noexcept {}
+    };
+
+    class ScopedDesignTimer
+    {
+    public:
+        explicit ScopedDesignTimer(PerformanceMonitor&) noexcept {}
+    };
+
+    void RecordCoefficientUpdate() noexcept {}
+    void RecordRampUpdate() noexcept {}
+
+    Snapshot GetSnapshot() const noexcept { return {}; }
+    void Reset() noexcept {}
+
+    void StartLogging(const juce::File&, int = 1000) {}
+    void StopLogging() {}
+   #endif
+};
@@ -1,311 +1,1588 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-ChannelEQAudioProcessor::ChannelEQAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
-#endif
-{
-}
-
-ChannelEQAudioProcessor::~ChannelEQAudioProcessor()
-{
-}
-
-//==============================================================================
-const juce::String ChannelEQAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool ChannelEQAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ChannelEQAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ChannelEQAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double ChannelEQAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int ChannelEQAudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int ChannelEQAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void ChannelEQAudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String ChannelEQAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void ChannelEQAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void ChannelEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
-    juce::dsp::ProcessSpec Spec;
-    
-    Spec.maximumBlockSize = samplesPerBlock;
-    Spec.numChannels = 1; // for mono
-    Spec.sampleRate = sampleRate;
-    
-    LeftChain.prepare(Spec);
-    RightChain.prepare(Spec);
-    
-    UpdateFilters();
-    
-}
-
-void ChannelEQAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool ChannelEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-void ChannelEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    // In case we have more outputs than inputs, this code clears any output
-    // channels that didn't contain input data, (because these aren't
-    // guaranteed to be empty - they may contain garbage).
-    // This is here to avoid people getting screaming feedback
-    // when they first compile a plugin, but obviously you don't need to keep
-    // this code if your algorithm always overwrites all the output channels.
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-    
-    UpdateFilters();
-
-    juce::dsp::AudioBlock<float> Block(buffer);
-    auto LeftBlock = Block.getSingleChannelBlock(0);
-    auto RightBlock = Block.getSingleChannelBlock(1);
-    
-    juce::dsp::ProcessContextReplacing<float> LeftContext(LeftBlock);
-    juce::dsp::ProcessContextReplacing<float> RightContext(RightBlock);
-    
-    LeftChain.process(LeftContext);
-    RightChain.process(RightContext);
-}
-
-//==============================================================================
-bool ChannelEQAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* ChannelEQAudioProcessor::createEditor()
-{
-    return new ChannelEQAudioProcessorEditor (*this);
-    //return new juce::GenericAudioProcessorEditor(*this);
-}
-
-//==============================================================================
-void ChannelEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
-}
-
-void ChannelEQAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid())
-    {
-        apvts.replaceState(tree);
-        UpdateFilters();
-    }
-}
-
-ChainSettings GetChainSettings(juce::AudioProcessorValueTreeState &apvts)
-{
-    ChainSettings Settings;
-    
-    Settings.LowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    Settings.LowCutSlope = static_cast<Slope> (apvts.getRawParameterValue("LowCut Slope")->load());
-    Settings.HighCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    Settings.HighCutSlope = static_cast<Slope> (apvts.getRawParameterValue("HighCut Slope")->load());
-    Settings.BellFreq = apvts.getRawParameterValue("Bell Freq")->load();
-    Settings.BellGainInDB = apvts.getRawParameterValue("Bell Gain")->load();
-    Settings.BellQ = apvts.getRawParameterValue("Bell Width (Q)")->load();
-    
-    return Settings;
-}
-
-void ChannelEQAudioProcessor::UpdateFilters()
-{
-    auto chainSettings = GetChainSettings(apvts);
-    UpdateLowCutFilter(chainSettings);
-    UpdateBellFilter(chainSettings);
-    UpdateHighCutFilter(chainSettings);
-    return;
-}
-
-void ChannelEQAudioProcessor::UpdateBellFilter(const ChainSettings &chainSettings)
-{
-    auto BellFilterCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(getSampleRate(), chainSettings.BellFreq, chainSettings.BellQ, juce::Decibels::decibelsToGain(chainSettings.BellGainInDB));
-    
-    UpdateCoefficients(LeftChain.get<ChainPositions::Bell>().coefficients, BellFilterCoefficients);
-    UpdateCoefficients(RightChain.get<ChainPositions::Bell>().coefficients, BellFilterCoefficients);
-    return;
-}
-
-void ChannelEQAudioProcessor::UpdateLowCutFilter(const ChainSettings &chainSettings)
-{
-    auto LowCutCoefficients = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.LowCutFreq, getSampleRate(), 2 * (chainSettings.LowCutSlope + 1));
-    
-    auto &LeftLowCut = LeftChain.get<ChainPositions::LowCut>();
-    UpdateCutFilter(LeftLowCut, LowCutCoefficients, chainSettings.LowCutSlope);
-    
-    auto &RightLowCut = RightChain.get<ChainPositions::LowCut>();
-    UpdateCutFilter(RightLowCut, LowCutCoefficients, chainSettings.LowCutSlope);
-    return;
-}
-
-void ChannelEQAudioProcessor::UpdateHighCutFilter(const ChainSettings &chainSettings)
-{
-    auto HighCutCoefficients = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.HighCutFreq, getSampleRate(), 2 * (chainSettings.HighCutSlope + 1));
-    
-    auto &LeftHighCut = LeftChain.get<ChainPositions::HighCut>();
-    UpdateCutFilter(LeftHighCut, HighCutCoefficients, chainSettings.HighCutSlope);
-    
-    auto &RightHighCut = RightChain.get<ChainPositions::HighCut>();
-    UpdateCutFilter(RightHighCut, HighCutCoefficients, chainSettings.HighCutSlope);
-    return;
-}
-
-void ChannelEQAudioProcessor::UpdateCoefficients(Coefficients &old, const Coefficients &replacements)
-{
-    *old = *replacements;
-    return;
-}
-
-juce::AudioProcessorValueTreeState::ParameterLayout ChannelEQAudioProcessor::CreateParameterLayout() // for layout of our parameters
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout Layout;
-    Layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq",
-                                                           "LowCut Freq",
-                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
-                                                           20.0f));
-    Layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq",
-                                                           "HighCut Freq",
-                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
-                                                           20000.0f));
-    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Freq",
-                                                           "Bell Freq",
-                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
-                                                           750.0f));
-    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Gain",
-                                                           "Bell Gain",
-                                                           juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f),
-                                                           0.0f));
-    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Width (Q)",
-                                                           "Bell Width (Q)",
-                                                           juce::NormalisableRange<float>(0.1f, 20.0f, 0.05f, 1.0f),
-                                                           0.7f));
-    juce::StringArray SlopeArray;
-    for (int i = 0; i < 5; ++i)
-    {
-        juce::String slope;
-        slope << (i + 1) * 12;
-        slope << " dB/oct";
-        SlopeArray.add(slope);
-    }
-    
-    Layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", SlopeArray, 0));
-    Layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", SlopeArray, 0));
-    
-    return Layout;
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new ChannelEQAudioProcessor();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+ChannelEQAudioProcessor::ChannelEQAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       )
+#endif
+{
+    for (auto *Parameter : getParameters())
+        if (auto *ParameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(Parameter))
+            apvts.addParameterListener(ParameterWithID->paramID, this);
+    
+    Bank = PresetBank::CreateFactoryBank(GetChainSettings(apvts));
+    
+   #if CHANNELEQ_INSTRUMENTATION
+    auto LogDirectory = juce::SystemStats::getEnvironmentVariable("CHANNELEQ_PERFORMANCE_LOG_DIR", {});
+    
+    if (LogDirectory.isNotEmpty())
+        Monitor.StartLogging(juce::File(LogDirectory).getNonexistentChildFile("ChannelEQ-performance", ".jsonl"));
+   #endif
+    
+    DesignThread->addTimeSliceClient(this);
+}
+
+ChannelEQAudioProcessor::~ChannelEQAudioProcessor()
+{
+    DesignThread->removeTimeSliceClient(this);
+    cancelPendingUpdate();
+    
+    for (auto *Parameter : getParameters())
+        if (auto *ParameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(Parameter))
+            apvts.removeParameterListener(ParameterWithID->paramID, this);
+}
+
+//==============================================================================
+const juce::String ChannelEQAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool ChannelEQAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ChannelEQAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ChannelEQAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double ChannelEQAudioProcessor::getTailLengthSeconds() const
+{
+    return TailLengthSeconds.load();
+}
+
+int ChannelEQAudioProcessor::getNumPrograms()
+{
+    const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+    return juce::jmax(1, Bank.GetNumPresets());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                                  // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int ChannelEQAudioProcessor::getCurrentProgram()
+{
+    return CurrentProgram.load();
+}
+
+void ChannelEQAudioProcessor::setCurrentProgram (int index)
+{
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+        
+        if (! juce::isPositiveAndBelow(index, Bank.GetNumPresets()))
+            return;
+    }
+    
+    ProgramChange Change {index, ++ProgramGeneration};
+    CurrentProgram = index;
+    RequestedProgram = Change;
+    ProgramToLoad = Change;
+}
+
+const juce::String ChannelEQAudioProcessor::getProgramName (int index)
+{
+    const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+    return juce::isPositiveAndBelow(index, Bank.GetNumPresets()) ? Bank.GetPreset(index).Name : juce::String();
+}
+
+void ChannelEQAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+    const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+    Bank.SetName(index, newName);
+}
+
+PresetBank ChannelEQAudioProcessor::GetPresetBank() const
+{
+    const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+    return Bank;
+}
+
+void ChannelEQAudioProcessor::SetPresetBank(const PresetBank &bank)
+{
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+        Bank = bank;
+        CurrentProgram = juce::jlimit(0, juce::jmax(0, Bank.GetNumPresets() - 1), CurrentProgram.load());
+    }
+    
+    PresetCoefficientsDirty = true;
+    FiltersDirty = true;
+    updateHostDisplay();
+    return;
+}
+
+//==============================================================================
+template <>
+ChannelEQAudioProcessor::Engine<float>& ChannelEQAudioProcessor::GetEngine<float>() noexcept
+{
+    return FloatEngine;
+}
+
+template <>
+ChannelEQAudioProcessor::Engine<double>& ChannelEQAudioProcessor::GetEngine<double>() noexcept
+{
+    return DoubleEngine;
+}
+
+template <typename Callback>
+void ChannelEQAudioProcessor::ForActiveEngine(Callback &&callback)
+{
+    if (DoublePrecision.load(std::memory_order_relaxed))
+        callback(DoubleEngine);
+    else
+        callback(FloatEngine);
+    return;
+}
+
+//==============================================================================
+void ChannelEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // Use this method as the place to do any pre-playback
+    // initialisation that you need..
+    // Sized for the negotiated main bus. The sidechain is only ever read by
+    // the detector.
+    auto NumChannels = (size_t) juce::jmax(getMainBusNumInputChannels(), getMainBusNumOutputChannels());
+    
+    {
+        // UpdateFilters() reads the precision and the oversamplers' latency
+        // on the designer thread.
+        const CheckedCriticalSection::ScopedLockType Lock(DesignLock);
+        
+        DoublePrecision = isUsingDoublePrecision();
+        
+        if (DoublePrecision)
+        {
+            PrepareEngine(DoubleEngine, NumChannels, sampleRate, samplesPerBlock);
+            FloatEngine = {};
+            LinearPhaseBuffer.setSize((int) NumChannels, samplesPerBlock);
+        }
+        else
+        {
+            PrepareEngine(FloatEngine, NumChannels, sampleRate, samplesPerBlock);
+            DoubleEngine = {};
+            LinearPhaseBuffer.setSize(0, 0);
+        }
+        
+        Convolver.prepare((int) NumChannels, LinearPhaseKernelLength, LinearPhasePartitionSize);
+        LinearPhaseActive = false;
+    }
+    
+    DynamicBell = {};
+    DynamicGainInDB = 0.0f;
+    MaximumBlockSize = samplesPerBlock;
+    
+    // A program picked while stopped has already reached the parameters.
+    RequestedProgram = ProgramChange {};
+    CrossfadeRemaining = 0;
+    
+    // Forces SetOversamplingOrder() on the first coefficients, which resets
+    // the smoothers for the new rate.
+    OversamplingOrder = -1;
+    SilentSamples = 0;
+    
+    DesignSampleRate = sampleRate;
+    FiltersDirty = false;
+    UpdateFilters();
+    ApplyPendingCoefficients();
+    
+    // The host reads the latency as soon as this returns.
+    setLatencySamples(DesignedLatencySamples.load());
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::PrepareEngine(Engine<SampleType> &engine, size_t numChannels, double sampleRate, int samplesPerBlock)
+{
+    // One cascade per group of NumLanes channels.
+    constexpr auto NumLanes = Engine<SampleType>::NumLanes;
+    engine.Cascades.resize((numChannels + NumLanes - 1) / NumLanes);
+    
+    for (auto &Group : engine.Cascades)
+        Group.prepare(samplesPerBlock);
+    
+    engine.SVFCascades.resize(engine.Cascades.size());
+    
+    for (auto &Group : engine.SVFCascades)
+        Group.prepare(samplesPerBlock);
+    
+    engine.FadeCascades.resize(engine.Cascades.size());
+    
+    for (auto &Group : engine.FadeCascades)
+        Group.prepare(samplesPerBlock);
+    
+    engine.FadeSVFCascades.resize(engine.Cascades.size());
+    
+    for (auto &Group : engine.FadeSVFCascades)
+        Group.prepare(samplesPerBlock);
+    
+    engine.CrossfadeBuffer.setSize((int) numChannels, samplesPerBlock << MaxOversamplingOrder);
+    
+    engine.Detector.prepare(sampleRate, DynamicBellSubBlockSize, juce::jmax(getTotalNumInputChannels(), (int) numChannels));
+    
+    for (int Order = 1; Order <= MaxOversamplingOrder; ++Order)
+    {
+        engine.Oversamplers[(size_t) Order] = std::make_unique<juce::dsp::Oversampling<SampleType>>(numChannels, (size_t) Order,
+                                                                                                     juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+                                                                                                     true, true);
+        engine.Oversamplers[(size_t) Order]->initProcessing((size_t) samplesPerBlock);
+    }
+    return;
+}
+
+void ChannelEQAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool ChannelEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // Any channel count works, from mono up to immersive beds, as long as
+    // the main bus is actually enabled. The sidechain bus may be disabled
+    // or any width.
+    if (layouts.getMainOutputChannelSet().isDisabled())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+template <typename SampleType>
+static bool IsBlockSilent(const juce::dsp::AudioBlock<SampleType> &block, float threshold)
+{
+    for (size_t Channel = 0; Channel < block.getNumChannels(); ++Channel)
+    {
+        auto Range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(Channel), (int) block.getNumSamples());
+        
+        if (juce::jmax(-Range.getStart(), Range.getEnd()) > threshold)
+            return false;
+    }
+    
+    return true;
+}
+
+void ChannelEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    ProcessBuffer(buffer, midiMessages);
+}
+
+void ChannelEQAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    ProcessBuffer(buffer, midiMessages);
+}
+
+bool ChannelEQAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessBuffer(juce::AudioBuffer<SampleType> &buffer, juce::MidiBuffer &midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    PerformanceMonitor::ScopedBlockTimer BlockTimer(Monitor, buffer.getNumSamples(), getSampleRate());
+    
+    // Offline rendering designs inline and may allocate; a live callback must not.
+    ScopedRealtimeTrap RealtimeTrap(! isNonRealtime());
+    
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // In case we have more outputs than inputs, this code clears any output
+    // channels that didn't contain input data, (because these aren't
+    // guaranteed to be empty - they may contain garbage).
+    // This is here to avoid people getting screaming feedback
+    // when they first compile a plugin, but obviously you don't need to keep
+    // this code if your algorithm always overwrites all the output channels.
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+    
+    // There is no background designer to wait for when rendering offline.
+    if (isNonRealtime())
+    {
+        TriggerProgramLoad();
+        
+        if (FiltersDirty.exchange(false))
+            UpdateFilters();
+    }
+    
+    ApplyPendingCoefficients();
+    ApplyPendingKernel();
+    
+    // After the pending coefficients, so that a design of the old program
+    // still in flight cannot land on top of the new one.
+    HandleProgramChanges(midiMessages);
+
+    // Only the engine prepareToPlay() built has any cascades; a call with
+    // the other precision would pass the audio through untouched.
+    auto &Active = GetEngine<SampleType>();
+    jassert(! Active.Cascades.empty());
+    
+    juce::dsp::AudioBlock<SampleType> Block(buffer);
+    auto NumChannels = juce::jmin(Block.getNumChannels(), (size_t) getMainBusNumOutputChannels(), Active.Cascades.size() * Engine<SampleType>::NumLanes);
+    
+    auto ProcessBlock = Block.getSubsetChannelBlock(0, NumChannels);
+    
+    // Silent input with the filters rung out gives silent output; skip the
+    // work so that an idle instance costs next to nothing.
+    if (IsBlockSilent(ProcessBlock, SilenceThreshold))
+    {
+        SilentSamples = juce::jmin(SilentSamples + buffer.getNumSamples(), std::numeric_limits<int>::max() / 2);
+        
+        if (SilentSamples > TailLengthSamples.load(std::memory_order_relaxed))
+            return;
+    }
+    else
+    {
+        SilentSamples = 0;
+    }
+    
+    auto TapAnalyzer = AnalyzerEnabled.load(std::memory_order_relaxed);
+    if (TapAnalyzer)
+        GetAnalyzerFifo(AnalyzerTap::PreEQ).Push(ProcessBlock);
+    
+    if (LinearPhaseActive)
+    {
+        ProcessLinearPhase(ProcessBlock);
+    }
+    else if (DynamicBell.Enabled)
+    {
+        // The main input is its own sidechain unless the sidechain bus is
+        // both asked for and connected.
+        auto Sidechain = ProcessBlock;
+        auto *SidechainBus = getBus(true, 1);
+        
+        if (DynamicBell.ExternalSidechain && SidechainBus != nullptr && SidechainBus->isEnabled())
+            Sidechain = Block.getSubsetChannelBlock((size_t) SidechainBus->getChannelIndexInProcessBlockBuffer(0),
+                                                    (size_t) SidechainBus->getNumberOfChannels());
+        
+        ProcessDynamicBell(ProcessBlock, Sidechain);
+    }
+    else
+    {
+        ProcessNaturalPhase(ProcessBlock);
+    }
+    
+    if (TapAnalyzer)
+        GetAnalyzerFifo(AnalyzerTap::PostEQ).Push(ProcessBlock);
+}
+
+//==============================================================================
+bool ChannelEQAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* ChannelEQAudioProcessor::createEditor()
+{
+    return new ChannelEQAudioProcessorEditor (*this);
+    //return new juce::GenericAudioProcessorEditor(*this);
+}
+
+//==============================================================================
+void ChannelEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    // You should use this method to store your parameters in the memory block.
+    // You could do that either as raw data, or use the XML or ValueTree classes
+    // as intermediaries to make it easy to save and load complex data.
+    auto State = apvts.copyState();
+    State.setProperty("PresetBank", GetPresetBank().ToBinary(), nullptr);
+    State.setProperty("Program", CurrentProgram.load(), nullptr);
+    
+    juce::MemoryOutputStream mos(destData, true);
+    State.writeToStream(mos);
+}
+
+void ChannelEQAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    // You should use this method to restore your parameters from this memory block,
+    // whose contents will have been created by the getStateInformation() call.
+    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+    if (tree.isValid())
+    {
+        // The bank stays binary; states from before it keep the factory bank.
+        if (auto *BankData = tree.getProperty("PresetBank").getBinaryData())
+        {
+            const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+            
+            if (Bank.Read(BankData->getData(), BankData->getSize()))
+                CurrentProgram = juce::jlimit(0, juce::jmax(0, Bank.GetNumPresets() - 1), (int) tree.getProperty("Program", 0));
+            
+            PresetCoefficientsDirty = true;
+        }
+        
+        tree.removeProperty("PresetBank", nullptr);
+        tree.removeProperty("Program", nullptr);
+        
+        apvts.replaceState(tree);
+        SetLinearPhaseOptions(tree.getProperty("LinearPhaseKernelLength", DefaultLinearPhaseKernelLength),
+                              tree.getProperty("LinearPhasePartitionSize", DefaultLinearPhasePartitionSize));
+        FiltersDirty = true;
+    }
+}
+
+void SetChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &chainSettings)
+{
+    auto Set = [&apvts](const juce::String &parameterID, float value)
+    {
+        if (auto *Parameter = apvts.getParameter(parameterID))
+            Parameter->setValueNotifyingHost(Parameter->convertTo0to1(value));
+    };
+    
+    Set("LowCut Freq", chainSettings.LowCutFreq);
+    Set("LowCut Slope", (float) chainSettings.LowCutSlope);
+    Set("HighCut Freq", chainSettings.HighCutFreq);
+    Set("HighCut Slope", (float) chainSettings.HighCutSlope);
+    Set("Bell Freq", chainSettings.BellFreq);
+    Set("Bell Gain", chainSettings.BellGainInDB);
+    Set("Bell Width (Q)", chainSettings.BellQ);
+    
+    auto &Dynamic = chainSettings.DynamicBell;
+    Set("Bell Dynamics", Dynamic.Enabled ? 1.0f : 0.0f);
+    Set("Bell Threshold", Dynamic.ThresholdInDB);
+    Set("Bell Ratio", Dynamic.Ratio);
+    Set("Bell Attack", Dynamic.AttackMs);
+    Set("Bell Release", Dynamic.ReleaseMs);
+    Set("Bell Sidechain", Dynamic.ExternalSidechain ? 1.0f : 0.0f);
+    
+    auto &MidSide = chainSettings.MidSide;
+    Set("Stereo Mode", MidSide.Enabled ? 1.0f : 0.0f);
+    Set("Side LowCut Freq", MidSide.LowCutFreq);
+    Set("Side LowCut Slope", (float) MidSide.LowCutSlope);
+    Set("Side HighCut Freq", MidSide.HighCutFreq);
+    Set("Side HighCut Slope", (float) MidSide.HighCutSlope);
+    Set("Side Bell Freq", MidSide.BellFreq);
+    Set("Side Bell Gain", MidSide.BellGainInDB);
+    Set("Side Bell Width (Q)", MidSide.BellQ);
+    
+    for (int i = 0; i < ChainSettings::MaxBands; ++i)
+    {
+        auto &Band = chainSettings.Bands[(size_t) i];
+        Set(GetBandParameterID(i, "Type"), (float) Band.Type);
+        Set(GetBandParameterID(i, "Freq"), Band.Freq);
+        Set(GetBandParameterID(i, "Gain"), Band.GainInDB);
+        Set(GetBandParameterID(i, "Q"), Band.Q);
+    }
+    return;
+}
+
+ChainSettings GetChainSettings(juce::AudioProcessorValueTreeState &apvts)
+{
+    ChainSettings Settings;
+    
+    Settings.LowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
+    Settings.LowCutSlope = static_cast<Slope> (apvts.getRawParameterValue("LowCut Slope")->load());
+    Settings.HighCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
+    Settings.HighCutSlope = static_cast<Slope> (apvts.getRawParameterValue("HighCut Slope")->load());
+    Settings.BellFreq = apvts.getRawParameterValue("Bell Freq")->load();
+    Settings.BellGainInDB = apvts.getRawParameterValue("Bell Gain")->load();
+    Settings.BellQ = apvts.getRawParameterValue("Bell Width (Q)")->load();
+    
+    auto &Dynamic = Settings.DynamicBell;
+    Dynamic.Enabled = apvts.getRawParameterValue("Bell Dynamics")->load() > 0.5f;
+    Dynamic.ThresholdInDB = apvts.getRawParameterValue("Bell Threshold")->load();
+    Dynamic.Ratio = apvts.getRawParameterValue("Bell Ratio")->load();
+    Dynamic.AttackMs = apvts.getRawParameterValue("Bell Attack")->load();
+    Dynamic.ReleaseMs = apvts.getRawParameterValue("Bell Release")->load();
+    Dynamic.ExternalSidechain = apvts.getRawParameterValue("Bell Sidechain")->load() > 0.5f;
+    
+    auto &MidSide = Settings.MidSide;
+    MidSide.Enabled = apvts.getRawParameterValue("Stereo Mode")->load() > 0.5f;
+    MidSide.LowCutFreq = apvts.getRawParameterValue("Side LowCut Freq")->load();
+    MidSide.LowCutSlope = static_cast<Slope> (apvts.getRawParameterValue("Side LowCut Slope")->load());
+    MidSide.HighCutFreq = apvts.getRawParameterValue("Side HighCut Freq")->load();
+    MidSide.HighCutSlope = static_cast<Slope> (apvts.getRawParameterValue("Side HighCut Slope")->load());
+    MidSide.BellFreq = apvts.getRawParameterValue("Side Bell Freq")->load();
+    MidSide.BellGainInDB = apvts.getRawParameterValue("Side Bell Gain")->load();
+    MidSide.BellQ = apvts.getRawParameterValue("Side Bell Width (Q)")->load();
+    
+    for (int i = 0; i < ChainSettings::MaxBands; ++i)
+    {
+        auto &Band = Settings.Bands[(size_t) i];
+        Band.Type = static_cast<BandType> (apvts.getRawParameterValue(GetBandParameterID(i, "Type"))->load());
+        Band.Freq = apvts.getRawParameterValue(GetBandParameterID(i, "Freq"))->load();
+        Band.GainInDB = apvts.getRawParameterValue(GetBandParameterID(i, "Gain"))->load();
+        Band.Q = apvts.getRawParameterValue(GetBandParameterID(i, "Q"))->load();
+    }
+    
+    return Settings;
+}
+
+juce::String GetBandParameterID(int band, const juce::String &name)
+{
+    return "Band " + juce::String(band + 1) + " " + name;
+}
+
+// True when one coefficient set can stand in for the other on the audio
+// thread: the same rate, oversampling, engine and precision.
+static bool HaveSameDesign(const ChainCoefficients &first, const ChainCoefficients &second)
+{
+    return first.SampleRate == second.SampleRate
+        && first.OversamplingOrder == second.OversamplingOrder
+        && first.Topology == second.Topology
+        && first.DoublePrecision == second.DoublePrecision;
+}
+
+void ChannelEQAudioProcessor::UpdateFilters()
+{
+    auto SampleRate = DesignSampleRate.load();
+    if (SampleRate <= 0.0)
+        return;
+    
+    // prepareToPlay and the background designer may both get here; the triple
+    // buffer only allows a single writer at a time. The parameters are read
+    // under the lock too, so the last set published is always of the newest
+    // parameters.
+    const CheckedCriticalSection::ScopedLockType Lock(DesignLock);
+    
+    // Read before the parameters, so a design that races a program load is
+    // stamped with the older generation.
+    auto Generation = ParameterGeneration.load();
+    auto chainSettings = GetChainSettings(apvts);
+    auto Order = juce::jlimit(0, MaxOversamplingOrder, (int) apvts.getRawParameterValue("Oversampling")->load());
+    auto LinearPhase = apvts.getRawParameterValue("Phase")->load() > 0.5f;
+    auto SVF = apvts.getRawParameterValue("Topology")->load() > 0.5f;
+    
+    // Mid/Side needs exactly a left and a right channel to encode.
+    chainSettings.MidSide.Enabled = chainSettings.MidSide.Enabled && getMainBusNumOutputChannels() == 2;
+    
+    PerformanceMonitor::ScopedDesignTimer DesignTimer(Monitor);
+    
+    // Designing at the oversampled rate is what keeps high bells and cuts
+    // from cramping towards the host's Nyquist frequency.
+    auto Coefficients = Cache->GetChainCoefficients(chainSettings, SampleRate * (1 << Order), DoublePrecision.load());
+    Coefficients.OversamplingOrder = Order;
+    Coefficients.Topology = SVF ? FilterTopology::SVF : FilterTopology::Biquad;
+    Coefficients.Generation = Generation;
+    PendingCoefficients.Write(Coefficients);
+    
+    if (PresetCoefficientsDirty.exchange(false) || ! HaveSameDesign(Coefficients, PresetReference))
+        DesignPresetCoefficients(Coefficients);
+    
+    // The kernel is sampled from the chain designed at the highest
+    // oversampled rate, so the FIR does not cramp either. A disabled kernel
+    // is still published, to tell the audio thread to leave linear-phase mode.
+    auto &Kernel = PendingKernels.GetWriteBuffer();
+    Kernel.Enabled = LinearPhase;
+    
+    if (LinearPhase)
+        DesignLinearPhaseKernel(Kernel, Cache->GetChainCoefficients(chainSettings, SampleRate * (1 << MaxOversamplingOrder)),
+                                SampleRate, LinearPhaseKernelLength, LinearPhasePartitionSize);
+    
+    PendingKernels.Publish();
+    
+    // Worked out here rather than on the audio thread, which only switches
+    // oversamplers once these coefficients arrive, and reported to the host
+    // from the message thread.
+    auto OversamplingLatency = 0.0;
+    
+    if (Order > 0)
+        ForActiveEngine([&](auto &engine) { OversamplingLatency = (double) engine.Oversamplers[(size_t) Order]->getLatencyInSamples(); });
+    
+    auto LatencySamples = LinearPhase ? LinearPhaseConvolver::GetLatencySamples(LinearPhaseKernelLength, LinearPhasePartitionSize)
+                                      : juce::roundToInt(OversamplingLatency);
+    
+    if (DesignedLatencySamples.exchange(LatencySamples) != LatencySamples)
+        triggerAsyncUpdate();
+    
+    // Tail in host samples. The convolver holds a whole kernel plus one
+    // partition; the cascades ring for their pole decay time, measured at
+    // the oversampled rate, and the half-band filters add about twice their
+    // latency on top.
+    auto TailSamples = LinearPhase ? (double) (LinearPhaseKernelLength + LinearPhasePartitionSize)
+                                   : GetChainTailSamples(Coefficients, TailDecayInDB) / (1 << Order) + 2.0 * OversamplingLatency;
+    
+    TailSamples = juce::jmin(TailSamples, MaximumTailSeconds * SampleRate);
+    TailLengthSamples = (int) std::ceil(TailSamples);
+    TailLengthSeconds = TailSamples / SampleRate;
+    return;
+}
+
+void ChannelEQAudioProcessor::DesignPresetCoefficients(const ChainCoefficients &reference)
+{
+    // Mostly cache hits: the sets are what UpdateFilters() would design for
+    // each preset's parameters anyway.
+    auto &Sets = PresetCoefficients.GetWriteBuffer();
+    auto Stereo = getMainBusNumOutputChannels() == 2;
+    
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+        Sets.resize((size_t) Bank.GetNumPresets());
+        
+        for (int i = 0; i < Bank.GetNumPresets(); ++i)
+        {
+            auto &Set = Sets[(size_t) i];
+            auto Settings = Bank.GetPreset(i).Settings;
+            Settings.MidSide.Enabled = Settings.MidSide.Enabled && Stereo;
+            
+            Set = Cache->GetChainCoefficients(Settings, reference.SampleRate, reference.DoublePrecision);
+            Set.OversamplingOrder = reference.OversamplingOrder;
+            Set.Topology = reference.Topology;
+        }
+    }
+    
+    PresetCoefficients.Publish();
+    PresetReference = reference;
+    return;
+}
+
+void ChannelEQAudioProcessor::HandleProgramChanges(const juce::MidiBuffer &midiMessages)
+{
+    // Programs switch at the start of the block, and the last change in it
+    // wins. Only a MIDI change still has to reach the parameters.
+    auto Change = RequestedProgram.exchange(ProgramChange {});
+    auto MidiProgram = -1;
+    
+    for (const auto Metadata : midiMessages)
+    {
+        auto Message = Metadata.getMessage();
+        
+        if (Message.isProgramChange())
+            MidiProgram = Message.getProgramChangeNumber();
+    }
+    
+    if (MidiProgram >= 0)
+        Change = {MidiProgram, ++ProgramGeneration};
+    
+    if (Change.Index < 0)
+        return;
+    
+    SwitchProgram(Change);
+    
+    if (MidiProgram >= 0)
+        ProgramToLoad = Change;
+    return;
+}
+
+bool ChannelEQAudioProcessor::SwitchProgram(const ProgramChange &change)
+{
+    PresetCoefficients.Update();
+    auto &Sets = PresetCoefficients.GetReadBuffer();
+    
+    if (! juce::isPositiveAndBelow(change.Index, (int) Sets.size()))
+        return false;
+    
+    // A set designed for another rate, engine or precision is stale, and the
+    // convolver needs a new kernel. Both wait for the parameters to arrive
+    // through the usual path, which ramps instead.
+    auto &Program = Sets[(size_t) change.Index];
+    
+    if (LinearPhaseActive || ! HaveSameDesign(Program, TargetCoefficients))
+        return false;
+    
+    StartCrossfade();
+    
+    // Land on the preset rather than ramp to it; the crossfade hides the jump.
+    SmoothingNeedsReset = true;
+    SetDynamicBell(Program.Settings);
+    StartSmoothing(Program);
+    
+    // Designs still under way for the outgoing program are dropped.
+    PlayingGeneration = change.Generation;
+    return true;
+}
+
+void ChannelEQAudioProcessor::TriggerProgramLoad()
+{
+    // Parameters are written, and the host told, on the message thread only.
+    if (ProgramToLoad.load().Index >= 0)
+        triggerAsyncUpdate();
+    
+    return;
+}
+
+void ChannelEQAudioProcessor::LoadPendingProgram()
+{
+    auto Change = ProgramToLoad.exchange(ProgramChange {});
+    auto Program = Change.Index;
+    if (Program < 0)
+        return;
+    
+    ChainSettings Settings;
+    
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(BankLock);
+        
+        if (! juce::isPositiveAndBelow(Program, Bank.GetNumPresets()))
+            return;
+        
+        Settings = Bank.GetPreset(Program).Settings;
+    }
+    
+    // The audio thread is already playing these; the design they trigger
+    // matches the preset's set, so it lands without a ramp.
+    CurrentProgram = Program;
+    SetChainSettings(apvts, Settings);
+    ParameterGeneration = Change.Generation;
+    
+    // Designs since the switch were dropped, and the parameters may not have
+    // changed at all; design again under the new generation either way.
+    FiltersDirty = true;
+    updateHostDisplay();
+    return;
+}
+
+void ChannelEQAudioProcessor::StartCrossfade()
+{
+    // The outgoing program keeps its state and coefficients in the fade
+    // cascades, and the incoming one starts from silence. A change during a
+    // fade drops the oldest program and fades out the newer one.
+    ForActiveEngine([](auto &engine)
+    {
+        std::swap(engine.Cascades, engine.FadeCascades);
+        std::swap(engine.SVFCascades, engine.FadeSVFCascades);
+    });
+    
+    ResetCascades();
+    
+    CrossfadeLength = juce::jmax(1, juce::roundToInt(ProgramCrossfadeSeconds * TargetCoefficients.SampleRate));
+    CrossfadeRemaining = CrossfadeLength;
+    return;
+}
+
+CoefficientCache::Statistics ChannelEQAudioProcessor::GetCoefficientCacheStatistics() const
+{
+    return Cache->GetStatistics();
+}
+
+void ChannelEQAudioProcessor::ApplyPendingCoefficients()
+{
+    if (! PendingCoefficients.Update())
+        return;
+    
+    // Designed from the parameters of a program that has since been switched
+    // away from: ramping to it would bring the outgoing program back until
+    // the new one's own design arrives.
+    auto &Pending = PendingCoefficients.GetReadBuffer();
+    
+    if (Pending.Generation < PlayingGeneration)
+        return;
+    
+    Monitor.RecordCoefficientUpdate();
+    
+    if (Pending.OversamplingOrder != OversamplingOrder)
+        SetOversamplingOrder(Pending.OversamplingOrder, Pending.SampleRate);
+    
+    // The other engine's state is stale; it starts from silence.
+    if (Pending.Topology != Topology)
+    {
+        Topology = Pending.Topology;
+        ResetCascades();
+    }
+    
+    // Lanes 0 and 1 change from left and right to Mid and Side or back, so
+    // their state is meaningless; start from silence at the new design.
+    if (Pending.Settings.MidSide.Enabled != TargetCoefficients.Settings.MidSide.Enabled)
+    {
+        ResetCascades();
+        SmoothingNeedsReset = true;
+    }
+    
+    // Before StartSmoothing(), which puts the static Bell back when the
+    // dynamic mode has just been switched off.
+    SetDynamicBell(Pending.Settings);
+    StartSmoothing(Pending);
+    return;
+}
+
+void ChannelEQAudioProcessor::ApplyPendingKernel()
+{
+    if (! PendingKernels.Update())
+        return;
+    
+    auto &Kernel = PendingKernels.GetReadBuffer();
+    
+    if (Kernel.Enabled != LinearPhaseActive)
+    {
+        // Switching between the cascades and the convolver: like a change of
+        // oversampling, both start again from silence.
+        Convolver.reset();
+        ResetCascades();
+        
+        LinearPhaseActive = Kernel.Enabled && Convolver.setKernel(Kernel, false);
+        return;
+    }
+    
+    if (LinearPhaseActive)
+        Convolver.setKernel(Kernel, true);
+    
+    return;
+}
+
+void ChannelEQAudioProcessor::ProcessLinearPhase(const juce::dsp::AudioBlock<float> &block)
+{
+    Convolver.process(block);
+    return;
+}
+
+void ChannelEQAudioProcessor::ProcessLinearPhase(const juce::dsp::AudioBlock<double> &block)
+{
+    auto NumChannels = juce::jmin(block.getNumChannels(), (size_t) LinearPhaseBuffer.getNumChannels());
+    auto NumSamples = block.getNumSamples();
+    
+    for (size_t Start = 0; Start < NumSamples; Start += (size_t) MaximumBlockSize)
+    {
+        auto Count = juce::jmin((size_t) MaximumBlockSize, NumSamples - Start);
+        
+        for (size_t Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            auto *Source = block.getChannelPointer(Channel) + Start;
+            auto *Destination = LinearPhaseBuffer.getWritePointer((int) Channel);
+            
+            for (size_t n = 0; n < Count; ++n)
+                Destination[n] = (float) Source[n];
+        }
+        
+        Convolver.process(juce::dsp::AudioBlock<float>(LinearPhaseBuffer).getSubsetChannelBlock(0, NumChannels).getSubBlock(0, Count));
+        
+        for (size_t Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            auto *Source = LinearPhaseBuffer.getReadPointer((int) Channel);
+            auto *Destination = block.getChannelPointer(Channel) + Start;
+            
+            for (size_t n = 0; n < Count; ++n)
+                Destination[n] = (double) Source[n];
+        }
+    }
+    return;
+}
+
+void ChannelEQAudioProcessor::SetLinearPhaseOptions(int kernelLength, int partitionSize)
+{
+    kernelLength = juce::jlimit(2 * LinearPhaseConvolver::MinimumPartitionSize, LinearPhaseConvolver::MaximumKernelLength, juce::nextPowerOfTwo(kernelLength));
+    partitionSize = juce::jlimit(LinearPhaseConvolver::MinimumPartitionSize, kernelLength, juce::nextPowerOfTwo(partitionSize));
+    
+    apvts.state.setProperty("LinearPhaseKernelLength", kernelLength, nullptr);
+    apvts.state.setProperty("LinearPhasePartitionSize", partitionSize, nullptr);
+    
+    if (kernelLength == LinearPhaseKernelLength && partitionSize == LinearPhasePartitionSize)
+        return;
+    
+    // Kernels still in flight for the old sizes are ignored by setKernel().
+    suspendProcessing(true);
+    {
+        const CheckedCriticalSection::ScopedLockType Lock(DesignLock);
+        LinearPhaseKernelLength = kernelLength;
+        LinearPhasePartitionSize = partitionSize;
+        
+        if (MaximumBlockSize > 0)
+        {
+            Convolver.prepare(juce::jmax(getMainBusNumInputChannels(), getMainBusNumOutputChannels()), kernelLength, partitionSize);
+            LinearPhaseActive = false;
+        }
+    }
+    suspendProcessing(false);
+    
+    FiltersDirty = true;
+    return;
+}
+
+void ChannelEQAudioProcessor::SetOversamplingOrder(int order, double designSampleRate)
+{
+    OversamplingOrder = order;
+    
+    if (order > 0)
+        ForActiveEngine([order](auto &engine) { engine.Oversamplers[(size_t) order]->reset(); });
+    
+    // The filter state belongs to the old rate, so start from silence.
+    ResetCascades();
+    
+    LowCutFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    HighCutFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    BellFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    BellGainSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    BellQSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    SideLowCutFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    SideHighCutFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    SideBellFreqSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    SideBellGainSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    SideBellQSmoother.reset(designSampleRate, SmoothingTimeSeconds);
+    
+    for (size_t Band = 0; Band < BandFreqSmoothers.size(); ++Band)
+    {
+        BandFreqSmoothers[Band].reset(designSampleRate, SmoothingTimeSeconds);
+        BandGainSmoothers[Band].reset(designSampleRate, SmoothingTimeSeconds);
+        BandQSmoothers[Band].reset(designSampleRate, SmoothingTimeSeconds);
+    }
+    
+    // Jump straight to the new design instead of ramping from the old rate.
+    SmoothingNeedsReset = true;
+    return;
+}
+
+void ChannelEQAudioProcessor::SetSmoothingSubBlockSize(int numSamples)
+{
+    SmoothingSubBlockSize = juce::jmax(1, numSamples);
+    return;
+}
+
+void ChannelEQAudioProcessor::StartSmoothing(const ChainCoefficients &target)
+{
+    // A band that changes type or is off has nothing to ramp from.
+    for (size_t Band = 0; Band < BandFreqSmoothers.size(); ++Band)
+    {
+        auto &Next = target.Settings.Bands[Band];
+        auto JumpBand = SmoothingNeedsReset || Next.Type == BandType::Off
+                     || Next.Type != TargetCoefficients.Settings.Bands[Band].Type;
+        
+        if (JumpBand)
+        {
+            BandFreqSmoothers[Band].setCurrentAndTargetValue(Next.Freq);
+            BandGainSmoothers[Band].setCurrentAndTargetValue(Next.GainInDB);
+            BandQSmoothers[Band].setCurrentAndTargetValue(Next.Q);
+        }
+        else
+        {
+            BandFreqSmoothers[Band].setTargetValue(Next.Freq);
+            BandGainSmoothers[Band].setTargetValue(Next.GainInDB);
+            BandQSmoothers[Band].setTargetValue(Next.Q);
+        }
+    }
+    
+    TargetCoefficients = target;
+    RampCoefficients = target;
+    
+    auto &Settings = target.Settings;
+    auto &Side = Settings.MidSide;
+    auto JumpSide = SmoothingNeedsReset || ! Side.Enabled;
+    
+    if (SmoothingNeedsReset)
+    {
+        SmoothingNeedsReset = false;
+        LowCutFreqSmoother.setCurrentAndTargetValue(Settings.LowCutFreq);
+        HighCutFreqSmoother.setCurrentAndTargetValue(Settings.HighCutFreq);
+        BellFreqSmoother.setCurrentAndTargetValue(Settings.BellFreq);
+        BellGainSmoother.setCurrentAndTargetValue(Settings.BellGainInDB);
+        BellQSmoother.setCurrentAndTargetValue(Settings.BellQ);
+    }
+    else
+    {
+        LowCutFreqSmoother.setTargetValue(Settings.LowCutFreq);
+        HighCutFreqSmoother.setTargetValue(Settings.HighCutFreq);
+        BellFreqSmoother.setTargetValue(Settings.BellFreq);
+        BellGainSmoother.setTargetValue(Settings.BellGainInDB);
+        BellQSmoother.setTargetValue(Settings.BellQ);
+    }
+    
+    if (JumpSide)
+    {
+        SideLowCutFreqSmoother.setCurrentAndTargetValue(Side.LowCutFreq);
+        SideHighCutFreqSmoother.setCurrentAndTargetValue(Side.HighCutFreq);
+        SideBellFreqSmoother.setCurrentAndTargetValue(Side.BellFreq);
+        SideBellGainSmoother.setCurrentAndTargetValue(Side.BellGainInDB);
+        SideBellQSmoother.setCurrentAndTargetValue(Side.BellQ);
+    }
+    else
+    {
+        SideLowCutFreqSmoother.setTargetValue(Side.LowCutFreq);
+        SideHighCutFreqSmoother.setTargetValue(Side.HighCutFreq);
+        SideBellFreqSmoother.setTargetValue(Side.BellFreq);
+        SideBellGainSmoother.setTargetValue(Side.BellGainInDB);
+        SideBellQSmoother.setTargetValue(Side.BellQ);
+    }
+    
+    // Nothing to ramp (e.g. only a slope changed): switch straight away.
+    if (! IsSmoothing())
+        SetCascadeCoefficients(TargetCoefficients);
+    
+    return;
+}
+
+bool ChannelEQAudioProcessor::IsSmoothing() const
+{
+    return LowCutFreqSmoother.isSmoothing()
+        || HighCutFreqSmoother.isSmoothing()
+        || BellFreqSmoother.isSmoothing()
+        || BellGainSmoother.isSmoothing()
+        || BellQSmoother.isSmoothing()
+        || SideLowCutFreqSmoother.isSmoothing()
+        || SideHighCutFreqSmoother.isSmoothing()
+        || SideBellFreqSmoother.isSmoothing()
+        || SideBellGainSmoother.isSmoothing()
+        || SideBellQSmoother.isSmoothing()
+        || std::any_of(BandFreqSmoothers.begin(), BandFreqSmoothers.end(), [](auto &Smoother) { return Smoother.isSmoothing(); })
+        || std::any_of(BandGainSmoothers.begin(), BandGainSmoothers.end(), [](auto &Smoother) { return Smoother.isSmoothing(); })
+        || std::any_of(BandQSmoothers.begin(), BandQSmoothers.end(), [](auto &Smoother) { return Smoother.isSmoothing(); });
+}
+
+bool ChannelEQAudioProcessor::IsBandSmoothing(size_t band) const
+{
+    return BandFreqSmoothers[band].isSmoothing() || BandGainSmoothers[band].isSmoothing() || BandQSmoothers[band].isSmoothing();
+}
+
+void ChannelEQAudioProcessor::UpdateSmoothedCoefficients(int numSamples)
+{
+    ScopedRealtimeTrap RampTrap;
+    
+    auto LowCutMoving = LowCutFreqSmoother.isSmoothing();
+    auto HighCutMoving = HighCutFreqSmoother.isSmoothing();
+    auto BellMoving = BellFreqSmoother.isSmoothing() || BellGainSmoother.isSmoothing() || BellQSmoother.isSmoothing();
+    auto SideMoving = SideLowCutFreqSmoother.isSmoothing() || SideHighCutFreqSmoother.isSmoothing() || SideBellFreqSmoother.isSmoothing()
+                   || SideBellGainSmoother.isSmoothing() || SideBellQSmoother.isSmoothing();
+    
+    std::array<bool, ChainSettings::MaxBands> BandMoving {};
+    
+    for (size_t Band = 0; Band < BandMoving.size(); ++Band)
+        BandMoving[Band] = IsBandSmoothing(Band);
+    
+    auto Settings = TargetCoefficients.Settings;
+    Settings.LowCutFreq = LowCutFreqSmoother.skip(numSamples);
+    Settings.HighCutFreq = HighCutFreqSmoother.skip(numSamples);
+    Settings.BellFreq = BellFreqSmoother.skip(numSamples);
+    Settings.BellGainInDB = BellGainSmoother.skip(numSamples);
+    Settings.BellQ = BellQSmoother.skip(numSamples);
+    Settings.MidSide.LowCutFreq = SideLowCutFreqSmoother.skip(numSamples);
+    Settings.MidSide.HighCutFreq = SideHighCutFreqSmoother.skip(numSamples);
+    Settings.MidSide.BellFreq = SideBellFreqSmoother.skip(numSamples);
+    Settings.MidSide.BellGainInDB = SideBellGainSmoother.skip(numSamples);
+    Settings.MidSide.BellQ = SideBellQSmoother.skip(numSamples);
+    
+    for (size_t Band = 0; Band < BandMoving.size(); ++Band)
+    {
+        Settings.Bands[Band].Freq = BandFreqSmoothers[Band].skip(numSamples);
+        Settings.Bands[Band].GainInDB = BandGainSmoothers[Band].skip(numSamples);
+        Settings.Bands[Band].Q = BandQSmoothers[Band].skip(numSamples);
+    }
+    
+    // The last step lands exactly on the target, which was designed off the
+    // audio thread already.
+    if (! IsSmoothing())
+    {
+        SetCascadeCoefficients(TargetCoefficients);
+        return;
+    }
+    
+    auto SampleRate = TargetCoefficients.SampleRate;
+    Monitor.RecordRampUpdate();
+    
+    // The SVF retunes every section from the settings directly.
+    if (Topology == FilterTopology::SVF)
+    {
+        ForActiveEngine([&](auto &engine)
+        {
+            for (auto &Group : engine.SVFCascades)
+                Group.setParameters(Settings, SampleRate);
+        });
+        
+        if (DynamicBell.Enabled)
+            ApplyDynamicBell(true);
+        return;
+    }
+    
+    if (LowCutMoving)
+        DesignLowCutCoefficients(RampCoefficients, Settings, SampleRate);
+    
+    if (HighCutMoving)
+        DesignHighCutCoefficients(RampCoefficients, Settings, SampleRate);
+    
+    if (BellMoving)
+        DesignBellCoefficients(RampCoefficients, Settings, SampleRate);
+    
+    if (SideMoving)
+        DesignSideCoefficients(RampCoefficients, Settings, SampleRate);
+    
+    for (size_t Band = 0; Band < BandMoving.size(); ++Band)
+    {
+        if (BandMoving[Band])
+            RampCoefficients.Bands[Band] = DesignBandSection(Settings.Bands[Band], SampleRate, RampCoefficients.DoublePrecision);
+    }
+    
+    SetCascadeCoefficients(RampCoefficients);
+    return;
+}
+
+void ChannelEQAudioProcessor::ResetCascades()
+{
+    ForActiveEngine([](auto &engine)
+    {
+        for (auto &Group : engine.Cascades)
+            Group.reset();
+        
+        for (auto &Group : engine.SVFCascades)
+            Group.reset();
+    });
+    
+    CrossfadeRemaining = 0;
+    return;
+}
+
+void ChannelEQAudioProcessor::SetCascadeCoefficients(const ChainCoefficients &chainCoefficients)
+{
+    ForActiveEngine([&](auto &engine)
+    {
+        if (Topology == FilterTopology::SVF)
+        {
+            for (auto &Group : engine.SVFCascades)
+                Group.setParameters(chainCoefficients.Settings, chainCoefficients.SampleRate);
+        }
+        else
+        {
+            for (auto &Group : engine.Cascades)
+                Group.setCoefficients(chainCoefficients);
+        }
+    });
+    
+    // That loaded the static Bell; put the dynamic gain back on top.
+    if (DynamicBell.Enabled)
+        ApplyDynamicBell(true);
+    return;
+}
+
+void ChannelEQAudioProcessor::SetDynamicBell(const ChainSettings &chainSettings)
+{
+    auto &Settings = chainSettings.DynamicBell;
+    
+    // Switched on: start from a closed envelope rather than whatever was
+    // left from the last time.
+    auto Restart = Settings.Enabled && ! DynamicBell.Enabled;
+    
+    if (Restart)
+        DynamicGainInDB = 0.0f;
+    
+    DynamicBell = Settings;
+    
+    ForActiveEngine([&](auto &engine)
+    {
+        if (Restart)
+            engine.Detector.reset();
+        
+        engine.Detector.setParameters(chainSettings.BellFreq, chainSettings.BellQ, Settings.AttackMs, Settings.ReleaseMs);
+        
+        for (auto &Group : engine.Cascades)
+            Group.setBellModulated(Settings.Enabled);
+    });
+    return;
+}
+
+void ChannelEQAudioProcessor::ApplyDynamicBell(bool cascadesOverwritten)
+{
+    BandSettings Bell;
+    Bell.Type = BandType::Bell;
+    Bell.Freq = BellFreqSmoother.getCurrentValue();
+    Bell.Q = BellQSmoother.getCurrentValue();
+    
+    // Rounded to 0.1 dB, so that a steady envelope keeps reusing the last
+    // design, and kept within the "Bell Gain" range.
+    auto GainInDB = juce::jlimit(-24.0f, 24.0f, BellGainSmoother.getCurrentValue() + DynamicGainInDB);
+    Bell.GainInDB = std::round(GainInDB * 10.0f) / 10.0f;
+    
+    auto Changed = Bell.Freq != LastDynamicBell.Freq || Bell.Q != LastDynamicBell.Q || Bell.GainInDB != LastDynamicBell.GainInDB;
+    
+    if (! Changed && ! cascadesOverwritten)
+        return;
+    
+    LastDynamicBell = Bell;
+    auto SampleRate = TargetCoefficients.SampleRate;
+    
+    if (Topology == FilterTopology::Biquad)
+        DynamicBellCoefficients = DesignBandSection(Bell, SampleRate, TargetCoefficients.DoublePrecision);
+    
+    ForActiveEngine([&](auto &engine)
+    {
+        if (Topology == FilterTopology::SVF)
+        {
+            for (auto &Group : engine.SVFCascades)
+                Group.setBell(Bell, SampleRate);
+        }
+        else
+        {
+            for (auto &Group : engine.Cascades)
+                Group.setBellCoefficients(DynamicBellCoefficients);
+        }
+    });
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessDynamicBell(const juce::dsp::AudioBlock<SampleType> &block, const juce::dsp::AudioBlock<SampleType> &sidechain)
+{
+    // Compression above the threshold for a ratio over 1, expansion for a
+    // ratio under 1. The detector reads each sub-block before it is filtered
+    // in place, so the internal sidechain always hears the dry input.
+    auto &Detector = GetEngine<SampleType>().Detector;
+    auto Slope = 1.0f / DynamicBell.Ratio - 1.0f;
+    auto NumSamples = block.getNumSamples();
+    
+    for (size_t Start = 0; Start < NumSamples; Start += (size_t) DynamicBellSubBlockSize)
+    {
+        auto Count = juce::jmin((size_t) DynamicBellSubBlockSize, NumSamples - Start);
+        auto LevelInDB = (float) Detector.process(sidechain.getSubBlock(Start, Count));
+        
+        DynamicGainInDB = juce::jmax(0.0f, LevelInDB - DynamicBell.ThresholdInDB) * Slope;
+        ApplyDynamicBell(false);
+        
+        ProcessNaturalPhase(block.getSubBlock(Start, Count));
+    }
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessCascades(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    auto &Active = GetEngine<SampleType>();
+    
+    if (CrossfadeRemaining > 0)
+        ProcessCrossfade(block);
+    else
+        ProcessGroups(block, Active.Cascades, Active.SVFCascades);
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessGroups(const juce::dsp::AudioBlock<SampleType> &block,
+                                            std::vector<SIMDFilterCascade<SampleType>> &cascades,
+                                            std::vector<SVFFilterCascade<SampleType>> &svfCascades)
+{
+    constexpr auto NumLanes = Engine<SampleType>::NumLanes;
+    auto NumChannels = block.getNumChannels();
+    
+    for (size_t Group = 0; Group * NumLanes < NumChannels; ++Group)
+    {
+        auto FirstChannel = Group * NumLanes;
+        auto NumGroupChannels = juce::jmin(NumLanes, NumChannels - FirstChannel);
+        
+        auto GroupBlock = block.getSubsetChannelBlock(FirstChannel, NumGroupChannels);
+        
+        if (Topology == FilterTopology::SVF)
+            svfCascades[Group].process(GroupBlock);
+        else
+            cascades[Group].process(GroupBlock);
+    }
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessCrossfade(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    auto &Active = GetEngine<SampleType>();
+    auto NumChannels = block.getNumChannels();
+    auto NumSamples = block.getNumSamples();
+    auto Capacity = (size_t) Active.CrossfadeBuffer.getNumSamples();
+    auto Step = (SampleType) 1 / (SampleType) CrossfadeLength;
+    
+    for (size_t Start = 0; Start < NumSamples; Start += Capacity)
+    {
+        auto Count = juce::jmin(Capacity, NumSamples - Start);
+        auto Incoming = block.getSubBlock(Start, Count);
+        auto Outgoing = juce::dsp::AudioBlock<SampleType>(Active.CrossfadeBuffer).getSubsetChannelBlock(0, NumChannels).getSubBlock(0, Count);
+        
+        Outgoing.copyFrom(Incoming);
+        ProcessGroups(Outgoing, Active.FadeCascades, Active.FadeSVFCascades);
+        ProcessGroups(Incoming, Active.Cascades, Active.SVFCascades);
+        
+        // A linear fade is enough: both sides are the same input through
+        // similar filters, so they are strongly correlated.
+        auto FirstGain = (SampleType) (CrossfadeLength - CrossfadeRemaining + 1) * Step;
+        
+        for (size_t Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            auto *Destination = Incoming.getChannelPointer(Channel);
+            auto *Source = Outgoing.getChannelPointer(Channel);
+            
+            for (size_t n = 0; n < Count; ++n)
+            {
+                auto Gain = juce::jmin((SampleType) 1, FirstGain + (SampleType) n * Step);
+                Destination[n] = Source[n] + Gain * (Destination[n] - Source[n]);
+            }
+        }
+        
+        CrossfadeRemaining = juce::jmax(0, CrossfadeRemaining - (int) Count);
+        
+        if (CrossfadeRemaining == 0)
+        {
+            if (Start + Count < NumSamples)
+                ProcessGroups(block.getSubBlock(Start + Count), Active.Cascades, Active.SVFCascades);
+            return;
+        }
+    }
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessFilters(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    if (IsSmoothing())
+        ProcessWithSmoothing(block);
+    else
+        ProcessCascades(block);
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessNaturalPhase(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    if (OversamplingOrder > 0)
+        ProcessOversampled(block);
+    else
+        ProcessFilters(block);
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessOversampled(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    auto &Oversampler = *GetEngine<SampleType>().Oversamplers[(size_t) OversamplingOrder];
+    auto NumSamples = block.getNumSamples();
+    
+    // The oversampler's buffers only hold what prepareToPlay() asked for.
+    for (size_t Start = 0; Start < NumSamples; Start += (size_t) MaximumBlockSize)
+    {
+        auto SubBlock = block.getSubBlock(Start, juce::jmin((size_t) MaximumBlockSize, NumSamples - Start));
+        
+        ProcessFilters(Oversampler.processSamplesUp(SubBlock));
+        Oversampler.processSamplesDown(SubBlock);
+    }
+    return;
+}
+
+template <typename SampleType>
+void ChannelEQAudioProcessor::ProcessWithSmoothing(const juce::dsp::AudioBlock<SampleType> &block)
+{
+    // Coefficients are recomputed once per sub-block, and only for the filters
+    // that are ramping. The worst case, all five continuous parameters moving
+    // at once, is one low cut, one high cut and one bell design per
+    // sub-block: 3 * 48000 / 32 = 4500 designs per second at 48 kHz with the
+    // default 32-sample sub-block. This lasts for SmoothingTimeSeconds after
+    // the last change. Once every ramp has finished, processBlock goes back
+    // to the plain cascade. The designs write into fixed-size arrays and
+    // never allocate or lock.
+    // When oversampled the sub-block is scaled by the factor, so the number
+    // of designs per second of audio stays the same. The SVF engine only
+    // retunes, so it uses a much shorter, fixed sub-block.
+    auto SubBlockSize = Topology == FilterTopology::SVF
+                      ? (size_t) SVFSmoothingSubBlockSize
+                      : (size_t) SmoothingSubBlockSize.load(std::memory_order_relaxed) << juce::jmax(0, OversamplingOrder);
+    auto NumSamples = block.getNumSamples();
+    
+    for (size_t Start = 0; Start < NumSamples; Start += SubBlockSize)
+    {
+        auto Count = juce::jmin(SubBlockSize, NumSamples - Start);
+        
+        if (IsSmoothing())
+            UpdateSmoothedCoefficients((int) Count);
+        
+        ProcessCascades(block.getSubBlock(Start, Count));
+    }
+    return;
+}
+
+void ChannelEQAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    FiltersDirty = true;
+    return;
+}
+
+void ChannelEQAudioProcessor::DesignPendingChanges()
+{
+    TriggerProgramLoad();
+    
+    // Even when the background designer has already taken the change: its
+    // design may still be under way, and this one lands after it.
+    FiltersDirty = false;
+    UpdateFilters();
+    return;
+}
+
+int ChannelEQAudioProcessor::useTimeSlice()
+{
+    TriggerProgramLoad();
+    
+    if (FiltersDirty.exchange(false))
+        UpdateFilters();
+    
+    return 5; // ms until the next poll
+}
+
+void ChannelEQAudioProcessor::handleAsyncUpdate()
+{
+    LoadPendingProgram();
+    
+    auto LatencySamples = DesignedLatencySamples.load();
+    
+    if (LatencySamples != getLatencySamples())
+        setLatencySamples(LatencySamples);
+    
+    return;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout ChannelEQAudioProcessor::CreateParameterLayout() // for layout of our parameters
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout Layout;
+    Layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq",
+                                                           "LowCut Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           20.0f));
+    Layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq",
+                                                           "HighCut Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           20000.0f));
+    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Freq",
+                                                           "Bell Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           750.0f));
+    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Gain",
+                                                           "Bell Gain",
+                                                           juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f),
+                                                           0.0f));
+    Layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Width (Q)",
+                                                           "Bell Width (Q)",
+                                                           juce::NormalisableRange<float>(0.1f, 20.0f, 0.05f, 1.0f),
+                                                           0.7f));
+    juce::StringArray SlopeArray;
+    for (int i = 0; i < 5; ++i)
+    {
+        juce::String slope;
+        slope << (i + 1) * 12;
+        slope << " dB/oct";
+        SlopeArray.add(slope);
+    }
+    
+    Layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", SlopeArray, 0));
+    Layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", SlopeArray, 0));
+    
+    Layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", "Oversampling", juce::StringArray {"Off", "2x", "4x"}, 0));
+    Layout.add(std::make_unique<juce::AudioParameterChoice>("Phase", "Phase", juce::StringArray {"Natural", "Linear"}, 0));
+    Layout.add(std::make_unique<juce::AudioParameterChoice>("Topology", "Topology", juce::StringArray {"Biquad", "SVF"}, 0));
+    
+    AddDynamicBellParameters(Layout);
+    AddBandParameters(Layout);
+    AddMidSideParameters(Layout);
+    
+    return Layout;
+}
+
+void ChannelEQAudioProcessor::AddBandParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout)
+{
+    // Same ranges and steps as the Bell, which is also the grid the
+    // coefficient cache quantises to.
+    juce::StringArray TypeArray {"Off", "Bell", "Low Shelf", "High Shelf", "Notch", "Low Cut", "High Cut"};
+    
+    for (int Band = 0; Band < ChainSettings::MaxBands; ++Band)
+    {
+        // Spread an octave apart from 100 Hz, so enabling a band lands somewhere useful.
+        auto DefaultFreq = juce::jmin(16000.0f, 100.0f * std::pow(2.0f, (float) Band));
+        
+        layout.add(std::make_unique<juce::AudioParameterChoice>(GetBandParameterID(Band, "Type"), GetBandParameterID(Band, "Type"), TypeArray, 0));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(GetBandParameterID(Band, "Freq"),
+                                                               GetBandParameterID(Band, "Freq"),
+                                                               juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                               DefaultFreq));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(GetBandParameterID(Band, "Gain"),
+                                                               GetBandParameterID(Band, "Gain"),
+                                                               juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f),
+                                                               0.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(GetBandParameterID(Band, "Q"),
+                                                               GetBandParameterID(Band, "Q"),
+                                                               juce::NormalisableRange<float>(0.1f, 20.0f, 0.05f, 1.0f),
+                                                               0.7f));
+    }
+    return;
+}
+
+void ChannelEQAudioProcessor::AddDynamicBellParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout)
+{
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Bell Dynamics", "Bell Dynamics", juce::StringArray {"Static", "Dynamic"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Threshold",
+                                                           "Bell Threshold",
+                                                           juce::NormalisableRange<float>(-60.0f, 0.0f, 0.5f, 1.0f),
+                                                           -24.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Ratio",
+                                                           "Bell Ratio",
+                                                           juce::NormalisableRange<float>(0.5f, 10.0f, 0.05f, 0.5f),
+                                                           2.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Attack",
+                                                           "Bell Attack",
+                                                           juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.4f),
+                                                           10.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Bell Release",
+                                                           "Bell Release",
+                                                           juce::NormalisableRange<float>(5.0f, 2000.0f, 1.0f, 0.4f),
+                                                           100.0f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Bell Sidechain", "Bell Sidechain", juce::StringArray {"Internal", "External"}, 0));
+    return;
+}
+
+void ChannelEQAudioProcessor::AddMidSideParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout)
+{
+    // Same ranges, steps and defaults as Mid's filters.
+    juce::StringArray SlopeArray {"12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct", "60 dB/oct"};
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Stereo Mode", "Stereo Mode", juce::StringArray {"Left/Right", "Mid/Side"}, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Side LowCut Freq",
+                                                           "Side LowCut Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           20.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Side HighCut Freq",
+                                                           "Side HighCut Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           20000.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Side Bell Freq",
+                                                           "Side Bell Freq",
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f),
+                                                           750.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Side Bell Gain",
+                                                           "Side Bell Gain",
+                                                           juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f),
+                                                           0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Side Bell Width (Q)",
+                                                           "Side Bell Width (Q)",
+                                                           juce::NormalisableRange<float>(0.1f, 20.0f, 0.05f, 1.0f),
+                                                           0.7f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Side LowCut Slope", "Side LowCut Slope", SlopeArray, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Side HighCut Slope", "Side HighCut Slope", SlopeArray, 0));
+    return;
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ChannelEQAudioProcessor();
+}
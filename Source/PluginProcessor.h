@@ -1,141 +1,391 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-enum Slope
-{
-    Slope_12, Slope_24, Slope_36, Slope_48, Slope_60
-};
-
-struct ChainSettings
-{
-    float BellFreq {0}, BellGainInDB {0}, BellQ {0};
-    float LowCutFreq {0}, HighCutFreq {0};
-    Slope LowCutSlope {Slope::Slope_12}, HighCutSlope {Slope::Slope_12};
-};
-
-using Filter = juce::dsp::IIR::Filter<float>;
-
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter, Filter>;
-
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-
-enum ChainPositions
-{
-    LowCut, Bell, HighCut
-};
-
-ChainSettings GetChainSettings(juce::AudioProcessorValueTreeState &apvts);
-
-//==============================================================================
-/**
-*/
-class ChannelEQAudioProcessor  : public juce::AudioProcessor
-{
-public:
-    //==============================================================================
-    ChannelEQAudioProcessor();
-    ~ChannelEQAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    static juce::AudioProcessorValueTreeState::ParameterLayout CreateParameterLayout(); // for layout of our parameters
-    juce::AudioProcessorValueTreeState apvts{*this, nullptr, "Parameters", CreateParameterLayout()};
-
-private:
-    MonoChain LeftChain, RightChain;
-    
-    using Coefficients = Filter::CoefficientsPtr;
-    
-    static void UpdateCoefficients(Coefficients &old, const Coefficients &replacements);
-    
-    template <int Index, typename ChainType, typename CoefficientType>
-    void update(ChainType &chain, CoefficientType &newCoefficients)
-    {
-        UpdateCoefficients(chain.template get<Index>().coefficients, newCoefficients[Index]);
-        chain.template setBypassed <Index>(false);
-    }
-    
-    template <typename ChainType, typename CoefficientType>
-    void UpdateCutFilter(ChainType &Cut, CoefficientType &CutCoefficients, const Slope &CutSlope)
-    {
-        Cut.template setBypassed <0>(true);
-        Cut.template setBypassed <1>(true);
-        Cut.template setBypassed <2>(true);
-        Cut.template setBypassed <3>(true);
-        Cut.template setBypassed <4>(true);
-        
-        switch (CutSlope)
-        {
-            case Slope_60:
-            {
-                update<4>(Cut, CutCoefficients);
-            }
-            case Slope_48:
-            {
-                update<3>(Cut, CutCoefficients);
-            }
-            case Slope_36:
-            {
-                update<2>(Cut, CutCoefficients);
-            }
-            case Slope_24:
-            {
-                update<1>(Cut, CutCoefficients);
-            }
-            case Slope_12:
-            {
-                update<0>(Cut, CutCoefficients);
-            }
-        }
-        return;
-    }
-    
-    void UpdateLowCutFilter(const ChainSettings &chainSettings);
-    void UpdateHighCutFilter(const ChainSettings &chainSettings);
-    void UpdateBellFilter(const ChainSettings &chainSettings);
-    
-    void UpdateFilters();
-    
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelEQAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+#include "TripleBuffer.h"
+#include "SIMDFilterCascade.h"
+#include "SVFFilterCascade.h"
+#include "CoefficientCache.h"
+#include "LinearPhaseConvolver.h"
+#include "AnalyzerFifo.h"
+#include "DynamicBellDetector.h"
+#include "PresetBank.h"
+#include "PerformanceMonitor.h"
+#include "RealtimeSafetyTrap.h"
+
+template <typename SampleType>
+using BasicFilter = juce::dsp::IIR::Filter<SampleType>;
+
+template <typename SampleType>
+using BasicCutFilter = juce::dsp::ProcessorChain<BasicFilter<SampleType>, BasicFilter<SampleType>, BasicFilter<SampleType>,
+                                                 BasicFilter<SampleType>, BasicFilter<SampleType>>;
+
+template <typename SampleType>
+using BasicMonoChain = juce::dsp::ProcessorChain<BasicCutFilter<SampleType>, BasicFilter<SampleType>, BasicCutFilter<SampleType>>;
+
+using Filter = BasicFilter<float>;
+using CutFilter = BasicCutFilter<float>;
+using MonoChain = BasicMonoChain<float>;
+
+enum ChainPositions
+{
+    LowCut, Bell, HighCut
+};
+
+ChainSettings GetChainSettings(juce::AudioProcessorValueTreeState &apvts);
+
+// The reverse: sets every parameter GetChainSettings() reads, notifying the host.
+void SetChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &chainSettings);
+
+// "Band 3 Freq" and so on; band is zero-based, the IDs count from 1.
+juce::String GetBandParameterID(int band, const juce::String &name);
+
+// One background thread shared by every instance in the process, so that
+// hundreds of instances do not each spin up their own designer thread.
+struct CoefficientDesignThread : juce::TimeSliceThread
+{
+    CoefficientDesignThread() : juce::TimeSliceThread("ChannelEQ Coefficient Designer")
+    {
+        startThread();
+    }
+};
+
+//==============================================================================
+/**
+*/
+class ChannelEQAudioProcessor  : public juce::AudioProcessor,
+                                 private juce::AudioProcessorValueTreeState::Listener,
+                                 private juce::TimeSliceClient,
+                                 private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    ChannelEQAudioProcessor();
+    ~ChannelEQAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // Doubles are filtered as doubles, with coefficients designed in double,
+    // rather than converted to float and back.
+    bool supportsDoublePrecisionProcessing() const override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    static juce::AudioProcessorValueTreeState::ParameterLayout CreateParameterLayout(); // for layout of our parameters
+    
+    // Type, Freq, Gain and Q for each of the ChainSettings::MaxBands bands.
+    static void AddBandParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout);
+    
+    // Mode, threshold, ratio, attack, release and sidechain source of the
+    // Bell's dynamic mode.
+    static void AddDynamicBellParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout);
+    
+    // "Stereo Mode", and Side's own LowCut, Bell and HighCut for Mid/Side mode.
+    static void AddMidSideParameters(juce::AudioProcessorValueTreeState::ParameterLayout &layout);
+    juce::AudioProcessorValueTreeState apvts{*this, nullptr, "Parameters", CreateParameterLayout()};
+    
+    // Hit/miss counters of the coefficient cache shared by all instances.
+    CoefficientCache::Statistics GetCoefficientCacheStatistics() const;
+    
+    // Does the background designer's work on the calling thread: the current
+    // parameters are designed and published now, after any design already
+    // under way, and a pending program load is handed to the message thread.
+    // For tools that drive the realtime path faster than real time. Never
+    // call it on the audio thread.
+    void DesignPendingChanges();
+    
+    // How often coefficients are recomputed while a parameter ramps, in
+    // samples. Smaller is smoother and costs more; see ProcessWithSmoothing().
+    void SetSmoothingSubBlockSize(int numSamples);
+    
+    static constexpr int DefaultSmoothingSubBlockSize = 32;
+    static constexpr double SmoothingTimeSeconds = 0.05;
+    
+    // With "Topology" = SVF a retune is a few tan()s and divisions rather
+    // than a redesign, so ramps update this often instead, in samples.
+    static constexpr int SVFSmoothingSubBlockSize = 4;
+    
+    // With "Bell Dynamics" = Dynamic the Bell's gain follows its detector,
+    // updated once per this many host samples.
+    static constexpr int DynamicBellSubBlockSize = 32;
+    
+    // "Oversampling" choices are Off, 2x and 4x: factor 2^order.
+    static constexpr int MaxOversamplingOrder = 2;
+    
+    // Kernel length and FFT partition size for the "Phase" = Linear mode,
+    // both powers of two. Latency is partitionSize + kernelLength / 2; a
+    // larger partition costs less CPU. Saved with the plugin state. Not
+    // realtime safe: processing is suspended while the convolver is rebuilt.
+    void SetLinearPhaseOptions(int kernelLength, int partitionSize);
+    
+    static constexpr int DefaultLinearPhaseKernelLength = 8192;
+    static constexpr int DefaultLinearPhasePartitionSize = 512;
+    
+    // Pre- and post-EQ sample taps for the spectrum analyzer. processBlock
+    // pushes nothing unless an analyzer has switched them on.
+    enum class AnalyzerTap
+    {
+        PreEQ, PostEQ
+    };
+    
+    AnalyzerFifo& GetAnalyzerFifo(AnalyzerTap tap) noexcept { return AnalyzerFifos[(size_t) tap]; }
+    void SetAnalyzerEnabled(bool shouldBeEnabled) noexcept { AnalyzerEnabled = shouldBeEnabled; }
+    
+    // The host's programs are the presets in this bank, which is saved with
+    // the plugin state. A program change, from the host or a MIDI program
+    // change, crossfades to coefficients designed ahead of time over
+    // ProgramCrossfadeSeconds; the parameters follow on the message thread.
+    PresetBank GetPresetBank() const;
+    void SetPresetBank(const PresetBank &bank);
+    
+    static constexpr double ProgramCrossfadeSeconds = 0.02;
+    
+    // Block timings, coefficient updates and host changes, for the editor's
+    // diagnostics panel. Empty unless CHANNELEQ_INSTRUMENTATION is set; then
+    // CHANNELEQ_PERFORMANCE_LOG_DIR, if set, also gets a log file per instance.
+    PerformanceMonitor& GetPerformanceMonitor() noexcept { return Monitor; }
+
+private:
+    // Everything that runs at the host's sample precision. Channels are
+    // processed in groups of NumLanes, one channel per SIMD lane; a 7.1.4
+    // bed runs three float cascades rather than twelve scalar chains. Only
+    // the cascades matching Topology are kept tuned and run.
+    //
+    // One oversampler per factor, all built in prepareToPlay(), so that the
+    // audio thread can switch between them without allocating. Index 0 is
+    // unused: order 0 runs the cascades at the host rate.
+    template <typename SampleType>
+    struct Engine
+    {
+        static constexpr size_t NumLanes = SIMDFilterCascade<SampleType>::NumLanes;
+        
+        std::vector<SIMDFilterCascade<SampleType>> Cascades;
+        std::vector<SVFFilterCascade<SampleType>> SVFCascades;
+        std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, MaxOversamplingOrder + 1> Oversamplers;
+        DynamicBellDetector<SampleType> Detector;
+        
+        // The outgoing program's cascades while a program change crossfades,
+        // and the copy of the input they filter.
+        std::vector<SIMDFilterCascade<SampleType>> FadeCascades;
+        std::vector<SVFFilterCascade<SampleType>> FadeSVFCascades;
+        juce::AudioBuffer<SampleType> CrossfadeBuffer;
+    };
+    
+    // prepareToPlay() builds only the engine for the host's precision, and
+    // only that one is retuned. The other one holds no memory.
+    Engine<float> FloatEngine;
+    Engine<double> DoubleEngine;
+    std::atomic<bool> DoublePrecision {false};
+    
+    template <typename SampleType>
+    Engine<SampleType>& GetEngine() noexcept;
+    
+    template <typename Callback>
+    void ForActiveEngine(Callback &&callback);
+    
+    template <typename SampleType>
+    void PrepareEngine(Engine<SampleType> &engine, size_t numChannels, double sampleRate, int samplesPerBlock);
+    
+    FilterTopology Topology {FilterTopology::Biquad};
+    int OversamplingOrder {0};
+    int MaximumBlockSize {0};
+    
+    template <typename SampleType>
+    void ProcessBuffer(juce::AudioBuffer<SampleType> &buffer, juce::MidiBuffer &midiMessages);
+    
+    void ResetCascades();
+    void SetCascadeCoefficients(const ChainCoefficients &chainCoefficients);
+    void SetOversamplingOrder(int order, double designSampleRate);
+    
+    template <typename SampleType> void ProcessCascades(const juce::dsp::AudioBlock<SampleType> &block);
+    template <typename SampleType> void ProcessCrossfade(const juce::dsp::AudioBlock<SampleType> &block);
+    
+    template <typename SampleType>
+    void ProcessGroups(const juce::dsp::AudioBlock<SampleType> &block,
+                       std::vector<SIMDFilterCascade<SampleType>> &cascades,
+                       std::vector<SVFFilterCascade<SampleType>> &svfCascades);
+    template <typename SampleType> void ProcessFilters(const juce::dsp::AudioBlock<SampleType> &block);
+    template <typename SampleType> void ProcessNaturalPhase(const juce::dsp::AudioBlock<SampleType> &block);
+    template <typename SampleType> void ProcessOversampled(const juce::dsp::AudioBlock<SampleType> &block);
+    
+    // Linear-phase mode replaces the cascades with one FIR convolution. The
+    // kernel is designed next to the coefficients and handed over the same way.
+    LinearPhaseConvolver Convolver;
+    TripleBuffer<LinearPhaseKernel> PendingKernels;
+    bool LinearPhaseActive {false};
+    int LinearPhaseKernelLength {DefaultLinearPhaseKernelLength};
+    int LinearPhasePartitionSize {DefaultLinearPhasePartitionSize};
+    
+    void ApplyPendingKernel();
+    
+    // juce::dsp::FFT only comes in float, so the double path converts
+    // through this buffer around the convolver.
+    juce::AudioBuffer<float> LinearPhaseBuffer;
+    
+    void ProcessLinearPhase(const juce::dsp::AudioBlock<float> &block);
+    void ProcessLinearPhase(const juce::dsp::AudioBlock<double> &block);
+    
+    // The dynamic Bell listens to the main input, or to the optional
+    // "Sidechain" bus, and moves the Bell's gain by DynamicGainInDB. The
+    // detector runs at the host rate; the Bell is redesigned only when the
+    // rounded gain changes. Linear-phase mode ignores it. The detectors live
+    // in the engines.
+    DynamicBellSettings DynamicBell;
+    float DynamicGainInDB {0};
+    BandSettings LastDynamicBell;
+    BiquadCoefficients DynamicBellCoefficients {};
+    
+    void SetDynamicBell(const ChainSettings &chainSettings);
+    void ApplyDynamicBell(bool cascadesOverwritten);
+    
+    template <typename SampleType>
+    void ProcessDynamicBell(const juce::dsp::AudioBlock<SampleType> &block, const juce::dsp::AudioBlock<SampleType> &sidechain);
+    
+    std::array<AnalyzerFifo, 2> AnalyzerFifos;
+    std::atomic<bool> AnalyzerEnabled {false};
+    
+    PerformanceMonitor Monitor;
+    
+    // Only the message and designer threads touch the bank. The audio thread
+    // reads PresetCoefficients instead: one set per preset, designed by
+    // UpdateFilters() next to PresetReference and redesigned whenever the
+    // bank or the rate, oversampling, engine or precision changes.
+    PresetBank Bank;
+    CheckedCriticalSection BankLock;
+    
+    TripleBuffer<std::vector<ChainCoefficients>> PresetCoefficients;
+    ChainCoefficients PresetReference;
+    std::atomic<bool> PresetCoefficientsDirty {true};
+    
+    // Every program change takes the next generation. The parameters carry
+    // the generation of the last program loaded into them, each design the
+    // one its parameters had, and the audio thread drops any design older
+    // than the program it is playing.
+    struct ProgramChange
+    {
+        int Index {-1}, Generation {0};
+    };
+    
+    // setCurrentProgram() hands RequestedProgram to the audio thread. The
+    // designer thread passes ProgramToLoad on to the message thread, which
+    // loads it into the parameters and tells the host.
+    std::atomic<int> CurrentProgram {0};
+    std::atomic<ProgramChange> RequestedProgram {ProgramChange {}}, ProgramToLoad {ProgramChange {}};
+    std::atomic<int> ProgramGeneration {0}, ParameterGeneration {0};
+    int PlayingGeneration {0};
+    
+    void DesignPresetCoefficients(const ChainCoefficients &reference);
+    void HandleProgramChanges(const juce::MidiBuffer &midiMessages);
+    bool SwitchProgram(const ProgramChange &change);
+    void TriggerProgramLoad();
+    void LoadPendingProgram();
+    
+    // Samples at the design rate; the crossfade runs inside the oversampling.
+    int CrossfadeLength {0}, CrossfadeRemaining {0};
+    
+    void StartCrossfade();
+    
+    // Input below SilenceThreshold (-120 dBFS) counts as silence; the tail is
+    // how long the filters take to decay by the same 120 dB. Once the input
+    // has been silent for longer than the tail, processBlock does nothing.
+    static constexpr float SilenceThreshold = 1.0e-6f;
+    static constexpr double TailDecayInDB = 120.0;
+    static constexpr double MaximumTailSeconds = 30.0;
+    
+    std::atomic<double> TailLengthSeconds {0.0};
+    std::atomic<int> TailLengthSamples {0};
+    int SilentSamples {0};
+    
+    // The latency of the last design. setLatencySamples() notifies the host
+    // synchronously, so it is applied on the message thread, or directly by
+    // prepareToPlay().
+    std::atomic<int> DesignedLatencySamples {0};
+    
+    // Designs a fresh coefficient set and publishes it to the audio thread.
+    // Never called on the audio thread, except when rendering offline.
+    void UpdateFilters();
+    
+    // Audio thread: picks up the latest published coefficients, if any, and
+    // starts ramping towards them.
+    void ApplyPendingCoefficients();
+    
+    void StartSmoothing(const ChainCoefficients &target);
+    bool IsSmoothing() const;
+    bool IsBandSmoothing(size_t band) const;
+    
+    // Audio thread: one ramp step. It only uses the allocation-free designers
+    // in ChainCoefficients.h, and arms the realtime trap even when rendering
+    // offline, so a ramp can never allocate in any mode.
+    void UpdateSmoothedCoefficients(int numSamples);
+    
+    template <typename SampleType>
+    void ProcessWithSmoothing(const juce::dsp::AudioBlock<SampleType> &block);
+    
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+    int useTimeSlice() override;
+    void handleAsyncUpdate() override;
+    
+    TripleBuffer<ChainCoefficients> PendingCoefficients;
+    std::atomic<bool> FiltersDirty {true};
+    std::atomic<double> DesignSampleRate {0.0};
+    CheckedCriticalSection DesignLock;
+    
+    juce::SharedResourcePointer<CoefficientDesignThread> DesignThread;
+    juce::SharedResourcePointer<CoefficientCache> Cache;
+    
+    // Only the continuous parameters are smoothed; slopes and band types
+    // switch at once. Side's only ramp in Mid/Side mode.
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> LowCutFreqSmoother, HighCutFreqSmoother, BellFreqSmoother;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> BellGainSmoother, BellQSmoother;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> SideLowCutFreqSmoother, SideHighCutFreqSmoother, SideBellFreqSmoother;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> SideBellGainSmoother, SideBellQSmoother;
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>, ChainSettings::MaxBands> BandFreqSmoothers;
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>, ChainSettings::MaxBands> BandGainSmoothers, BandQSmoothers;
+    
+    // Target is designed off the audio thread. Ramp holds the in-between
+    // coefficients, redesigned only for the filters that are moving.
+    ChainCoefficients TargetCoefficients, RampCoefficients;
+    bool SmoothingNeedsReset {true};
+    std::atomic<int> SmoothingSubBlockSize {DefaultSmoothingSubBlockSize};
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelEQAudioProcessor)
+};
@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    The plugin's programs, and their compact binary format.
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+// "CEQB", read as a little-endian int32.
+static constexpr int BankMagic = 0x42514543;
+
+// Bytes per preset after its name: five floats, two slopes, the dynamics
+// flags and four floats, from version 2 the Mid/Side flag, five floats and
+// two slopes, then a type and three floats per band.
+static constexpr juce::int64 FixedPresetBytes = 5 * 4 + 2 + 1 + 4 * 4;
+static constexpr juce::int64 MidSideBytes = 1 + 5 * 4 + 2;
+static constexpr juce::int64 BandBytes = 1 + 3 * 4;
+
+// Values are clamped to the ranges of CreateParameterLayout(), so a damaged
+// bank can never hand the designer a frequency of zero or a NaN.
+static float ReadFloat(juce::InputStream &stream, float minimum, float maximum)
+{
+    auto Value = stream.readFloat();
+    return std::isfinite(Value) ? juce::jlimit(minimum, maximum, Value) : minimum;
+}
+
+static int ReadChoice(juce::InputStream &stream, int numChoices)
+{
+    return juce::jlimit(0, numChoices - 1, (int) stream.readByte());
+}
+
+//==============================================================================
+PresetBank PresetBank::CreateFactoryBank(const ChainSettings &flatSettings)
+{
+    PresetBank Bank;
+    auto HasBand = ChainSettings::MaxBands > 0;
+
+    Bank.Add({"Flat", flatSettings});
+
+    auto Rumble = flatSettings;
+    Rumble.LowCutFreq = 80.0f;
+    Rumble.LowCutSlope = Slope_24;
+    Bank.Add({"Rumble Cut", Rumble});
+
+    auto Presence = Rumble;
+    Presence.LowCutFreq = 100.0f;
+    Presence.BellFreq = 3500.0f;
+    Presence.BellGainInDB = 3.0f;
+    Presence.BellQ = 1.0f;
+
+    if (HasBand)
+        Presence.Bands[0] = {BandType::HighShelf, 10000.0f, 2.0f, 0.7f};
+
+    Bank.Add({"Vocal Presence", Presence});
+
+    auto Mud = flatSettings;
+    Mud.BellFreq = 300.0f;
+    Mud.BellGainInDB = -4.0f;
+    Mud.BellQ = 1.4f;
+    Bank.Add({"De-Mud", Mud});
+
+    auto Telephone = flatSettings;
+    Telephone.LowCutFreq = 400.0f;
+    Telephone.LowCutSlope = Slope_48;
+    Telephone.HighCutFreq = 3400.0f;
+    Telephone.HighCutSlope = Slope_48;
+    Telephone.BellFreq = 1500.0f;
+    Telephone.BellGainInDB = 4.0f;
+    Telephone.BellQ = 1.0f;
+    Bank.Add({"Telephone", Telephone});
+
+    auto DeEss = flatSettings;
+    DeEss.BellFreq = 6500.0f;
+    DeEss.BellGainInDB = 0.0f;
+    DeEss.BellQ = 2.0f;
+    DeEss.DynamicBell.Enabled = true;
+    DeEss.DynamicBell.ThresholdInDB = -30.0f;
+    DeEss.DynamicBell.Ratio = 4.0f;
+    DeEss.DynamicBell.AttackMs = 1.0f;
+    DeEss.DynamicBell.ReleaseMs = 60.0f;
+    Bank.Add({"De-Ess", DeEss});
+
+    // Low end in mono: the Side channel is cut below 150 Hz.
+    auto MonoBass = flatSettings;
+    MonoBass.MidSide.Enabled = true;
+    MonoBass.MidSide.LowCutFreq = 150.0f;
+    MonoBass.MidSide.LowCutSlope = Slope_24;
+    Bank.Add({"Mono Bass", MonoBass});
+
+    return Bank;
+}
+
+//==============================================================================
+int PresetBank::Add(const Preset &preset)
+{
+    if (GetNumPresets() >= MaxPresets)
+        return -1;
+
+    Presets.push_back(preset);
+    return GetNumPresets() - 1;
+}
+
+void PresetBank::SetName(int index, const juce::String &name)
+{
+    if (juce::isPositiveAndBelow(index, GetNumPresets()))
+        Presets[(size_t) index].Name = name;
+    return;
+}
+
+void PresetBank::SetSettings(int index, const ChainSettings &settings)
+{
+    if (juce::isPositiveAndBelow(index, GetNumPresets()))
+        Presets[(size_t) index].Settings = settings;
+    return;
+}
+
+//==============================================================================
+void PresetBank::Write(juce::OutputStream &stream) const
+{
+    stream.writeInt(BankMagic);
+    stream.writeShort((short) Version);
+    stream.writeShort((short) ChainSettings::MaxBands);
+    stream.writeShort((short) Presets.size());
+
+    for (auto &Preset : Presets)
+    {
+        auto &Settings = Preset.Settings;
+        auto &Dynamic = Settings.DynamicBell;
+        auto &MidSide = Settings.MidSide;
+
+        stream.writeString(Preset.Name);
+
+        stream.writeFloat(Settings.LowCutFreq);
+        stream.writeFloat(Settings.HighCutFreq);
+        stream.writeFloat(Settings.BellFreq);
+        stream.writeFloat(Settings.BellGainInDB);
+        stream.writeFloat(Settings.BellQ);
+        stream.writeByte((char) Settings.LowCutSlope);
+        stream.writeByte((char) Settings.HighCutSlope);
+
+        stream.writeByte((char) ((Dynamic.Enabled ? 1 : 0) | (Dynamic.ExternalSidechain ? 2 : 0)));
+        stream.writeFloat(Dynamic.ThresholdInDB);
+        stream.writeFloat(Dynamic.Ratio);
+        stream.writeFloat(Dynamic.AttackMs);
+        stream.writeFloat(Dynamic.ReleaseMs);
+
+        stream.writeByte((char) (MidSide.Enabled ? 1 : 0));
+        stream.writeFloat(MidSide.LowCutFreq);
+        stream.writeFloat(MidSide.HighCutFreq);
+        stream.writeFloat(MidSide.BellFreq);
+        stream.writeFloat(MidSide.BellGainInDB);
+        stream.writeFloat(MidSide.BellQ);
+        stream.writeByte((char) MidSide.LowCutSlope);
+        stream.writeByte((char) MidSide.HighCutSlope);
+
+        for (auto &Band : Settings.Bands)
+        {
+            stream.writeByte((char) Band.Type);
+            stream.writeFloat(Band.Freq);
+            stream.writeFloat(Band.GainInDB);
+            stream.writeFloat(Band.Q);
+        }
+    }
+    return;
+}
+
+juce::MemoryBlock PresetBank::ToBinary() const
+{
+    juce::MemoryBlock Data;
+    juce::MemoryOutputStream Stream(Data, false);
+    Write(Stream);
+    Stream.flush();
+    return Data;
+}
+
+bool PresetBank::Read(const void *data, size_t sizeInBytes)
+{
+    juce::MemoryInputStream Stream(data, sizeInBytes, false);
+
+    if (Stream.getNumBytesRemaining() < 10 || Stream.readInt() != BankMagic)
+        return false;
+
+    auto FileVersion = (int) Stream.readShort();
+    auto NumBands = (int) Stream.readShort();
+    auto NumPresets = (int) Stream.readShort();
+
+    if (FileVersion < 1 || FileVersion > Version || NumBands < 0 || ! juce::isPositiveAndNotGreaterThan(NumPresets, MaxPresets))
+        return false;
+
+    auto PresetBytes = FixedPresetBytes + (FileVersion >= 2 ? MidSideBytes : 0) + NumBands * BandBytes;
+    std::vector<Preset> Loaded((size_t) NumPresets);
+
+    for (auto &Preset : Loaded)
+    {
+        Preset.Name = Stream.readString();
+
+        if (Stream.getNumBytesRemaining() < PresetBytes)
+            return false;
+
+        auto &Settings = Preset.Settings;
+        Settings.LowCutFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+        Settings.HighCutFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+        Settings.BellFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+        Settings.BellGainInDB = ReadFloat(Stream, -24.0f, 24.0f);
+        Settings.BellQ = ReadFloat(Stream, 0.1f, 20.0f);
+        Settings.LowCutSlope = static_cast<Slope> (ReadChoice(Stream, Slope_60 + 1));
+        Settings.HighCutSlope = static_cast<Slope> (ReadChoice(Stream, Slope_60 + 1));
+
+        auto &Dynamic = Settings.DynamicBell;
+        auto Flags = (int) Stream.readByte();
+        Dynamic.Enabled = (Flags & 1) != 0;
+        Dynamic.ExternalSidechain = (Flags & 2) != 0;
+        Dynamic.ThresholdInDB = ReadFloat(Stream, -60.0f, 0.0f);
+        Dynamic.Ratio = ReadFloat(Stream, 0.5f, 10.0f);
+        Dynamic.AttackMs = ReadFloat(Stream, 0.1f, 200.0f);
+        Dynamic.ReleaseMs = ReadFloat(Stream, 5.0f, 2000.0f);
+
+        if (FileVersion >= 2)
+        {
+            auto &MidSide = Settings.MidSide;
+            MidSide.Enabled = (Stream.readByte() & 1) != 0;
+            MidSide.LowCutFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+            MidSide.HighCutFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+            MidSide.BellFreq = ReadFloat(Stream, 20.0f, 20000.0f);
+            MidSide.BellGainInDB = ReadFloat(Stream, -24.0f, 24.0f);
+            MidSide.BellQ = ReadFloat(Stream, 0.1f, 20.0f);
+            MidSide.LowCutSlope = static_cast<Slope> (ReadChoice(Stream, Slope_60 + 1));
+            MidSide.HighCutSlope = static_cast<Slope> (ReadChoice(Stream, Slope_60 + 1));
+        }
+
+        for (int i = 0; i < NumBands; ++i)
+        {
+            BandSettings Band;
+            Band.Type = static_cast<BandType> (ReadChoice(Stream, (int) BandType::HighCut + 1));
+            Band.Freq = ReadFloat(Stream, 20.0f, 20000.0f);
+            Band.GainInDB = ReadFloat(Stream, -24.0f, 24.0f);
+            Band.Q = ReadFloat(Stream, 0.1f, 20.0f);
+
+            if (i < ChainSettings::MaxBands)
+                Settings.Bands[(size_t) i] = Band;
+        }
+    }
+
+    Presets = std::move(Loaded);
+    return true;
+}
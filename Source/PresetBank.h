@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    The plugin's programs, and their compact binary format.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+
+struct Preset
+{
+    juce::String Name;
+    ChainSettings Settings;
+};
+
+/**
+    An ordered list of presets, one per host program.
+
+    A preset holds the curve, the Bell's dynamics and the Mid/Side mode with
+    Side's filters, but not the
+    "Oversampling", "Phase" or "Topology" choices. Those are properties of
+    the instance, so a program change never changes the latency.
+
+    The binary form is little-endian:
+
+        int32   magic "CEQB"
+        int16   version
+        int16   number of bands per preset
+        int16   number of presets
+        then, per preset:
+        string  name, UTF-8, NUL-terminated
+        float   LowCut Freq, HighCut Freq, Bell Freq, Bell Gain, Bell Q
+        int8    LowCut Slope, HighCut Slope
+        int8    dynamics flags: 1 = enabled, 2 = external sidechain
+        float   threshold, ratio, attack, release
+        int8    Mid/Side: 1 = enabled                               (version 2)
+        float   Side LowCut Freq, HighCut Freq, Bell Freq, Gain, Q  (version 2)
+        int8    Side LowCut Slope, HighCut Slope                    (version 2)
+        then, per band:
+        int8    type
+        float   Freq, Gain, Q
+
+    Reading one is a straight pass with no parsing or allocation per value.
+    This is why presets load faster than through a ValueTree. A bank saved
+    with more bands than this build drops the extra ones. A bank with fewer
+    bands leaves the rest Off. A version 1 bank loads with Mid/Side off.
+*/
+class PresetBank
+{
+public:
+    static constexpr int Version = 2;
+    static constexpr int MaxPresets = 128;
+
+    PresetBank() = default;
+
+    /** A handful of starting points built on flatSettings, which should hold
+        the parameter defaults. The first preset is flatSettings itself.
+    */
+    static PresetBank CreateFactoryBank(const ChainSettings &flatSettings);
+
+    //==============================================================================
+    int GetNumPresets() const noexcept { return (int) Presets.size(); }
+    const Preset& GetPreset(int index) const { return Presets[(size_t) index]; }
+
+    /** Appends a preset and returns its index, or -1 once MaxPresets is reached. */
+    int Add(const Preset &preset);
+
+    void SetName(int index, const juce::String &name);
+    void SetSettings(int index, const ChainSettings &settings);
+
+    //==============================================================================
+    void Write(juce::OutputStream &stream) const;
+    juce::MemoryBlock ToBinary() const;
+
+    /** Replaces the bank with a binary one. Returns false, leaving the bank
+        unchanged, if the data is not a bank or is from a newer version.
+    */
+    bool Read(const void *data, size_t sizeInBytes);
+
+private:
+    std::vector<Preset> Presets;
+
+    JUCE_LEAK_DETECTOR (PresetBank)
+};
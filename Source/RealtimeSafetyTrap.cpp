@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyTrap.cpp
+    Debug-build trap for heap allocations and blocking locks on the audio thread.
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyTrap.h"
+
+#include <cstdlib>
+#include <new>
+
+#if CHANNELEQ_REALTIME_TRAP
+
+// Depth rather than a flag, so nested traps (a console inside a processor)
+// only disarm when the outermost one ends.
+static thread_local int ArmedDepth = 0;
+
+ScopedRealtimeTrap::ScopedRealtimeTrap(bool armed) noexcept : Armed(armed)
+{
+    if (Armed)
+        ++ArmedDepth;
+}
+
+ScopedRealtimeTrap::~ScopedRealtimeTrap() noexcept
+{
+    if (Armed)
+        --ArmedDepth;
+}
+
+bool ScopedRealtimeTrap::IsArmed() noexcept
+{
+    return ArmedDepth > 0;
+}
+
+void ScopedRealtimeTrap::Check(const char *operation) noexcept
+{
+    if (ArmedDepth == 0)
+        return;
+
+    // Reporting allocates, so disarm until it is done.
+    auto Depth = ArmedDepth;
+    ArmedDepth = 0;
+
+    DBG("Realtime-safety violation on the audio thread: " << operation);
+
+   #if CHANNELEQ_REALTIME_TRAP_ABORT
+    std::fprintf(stderr, "Realtime-safety violation on the audio thread: %s\n", operation);
+    std::abort();
+   #else
+    jassertfalse;
+   #endif
+
+    ArmedDepth = Depth;
+    return;
+}
+
+//==============================================================================
+#if CHANNELEQ_REALTIME_TRAP_GLOBAL_NEW
+
+// The complete replaceable set, so that no form of new escapes the trap
+// and every form of delete matches the allocator its new used.
+static void* Allocate(std::size_t size, const char *operation) noexcept
+{
+    ScopedRealtimeTrap::Check(operation);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    ScopedRealtimeTrap::Check("aligned allocation");
+    auto Alignment = juce::jmax((std::size_t) alignment, sizeof(void*));
+
+   #if JUCE_WINDOWS
+    return _aligned_malloc(size == 0 ? 1 : size, Alignment);
+   #else
+    void *Pointer = nullptr;
+    return posix_memalign(&Pointer, Alignment, size == 0 ? 1 : size) == 0 ? Pointer : nullptr;
+   #endif
+}
+
+static void FreeAligned(void *pointer) noexcept
+{
+   #if JUCE_WINDOWS
+    _aligned_free(pointer);
+   #else
+    std::free(pointer);
+   #endif
+}
+
+void* operator new (std::size_t size)
+{
+    if (auto *Pointer = Allocate(size, "allocation"))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    if (auto *Pointer = AllocateAligned(size, alignment))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+    return operator new (size, alignment);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept                               { return Allocate(size, "allocation"); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept                             { return Allocate(size, "allocation"); }
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return AllocateAligned(size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+
+void operator delete (void* pointer) noexcept                                               { std::free(pointer); }
+void operator delete[] (void* pointer) noexcept                                             { std::free(pointer); }
+void operator delete (void* pointer, std::size_t) noexcept                                  { std::free(pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept                                { std::free(pointer); }
+void operator delete (void* pointer, const std::nothrow_t&) noexcept                        { std::free(pointer); }
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept                      { std::free(pointer); }
+
+void operator delete (void* pointer, std::align_val_t) noexcept                             { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::align_val_t) noexcept                           { FreeAligned(pointer); }
+void operator delete (void* pointer, std::size_t, std::align_val_t) noexcept                { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::size_t, std::align_val_t) noexcept              { FreeAligned(pointer); }
+void operator delete (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept      { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept    { FreeAligned(pointer); }
+
+#endif
+
+#else
+
+ScopedRealtimeTrap::ScopedRealtimeTrap(bool armed) noexcept : Armed(armed) {}
+ScopedRealtimeTrap::~ScopedRealtimeTrap() noexcept { juce::ignoreUnused(Armed); }
+
+bool ScopedRealtimeTrap::IsArmed() noexcept                     { return false; }
+void ScopedRealtimeTrap::Check(const char *operation) noexcept  { juce::ignoreUnused(operation); }
+
+#endif
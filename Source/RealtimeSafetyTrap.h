@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyTrap.h
+    Debug-build trap for heap allocations and blocking locks on the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// On by default in debug builds. A build that replaces the global operator
+// new itself (the benchmark does) leaves CHANNELEQ_REALTIME_TRAP_GLOBAL_NEW
+// unset and calls ScopedRealtimeTrap::Check() from its own instead.
+#ifndef CHANNELEQ_REALTIME_TRAP
+ #if JUCE_DEBUG
+  #define CHANNELEQ_REALTIME_TRAP 1
+ #else
+  #define CHANNELEQ_REALTIME_TRAP 0
+ #endif
+#endif
+
+// Set to 1 in a standalone tool to also replace the global operator new and
+// delete, so that allocations are trapped too. The plugin never sets it: a
+// plugin binary must not interpose on its host's allocator.
+#ifndef CHANNELEQ_REALTIME_TRAP_GLOBAL_NEW
+ #define CHANNELEQ_REALTIME_TRAP_GLOBAL_NEW 0
+#endif
+
+// Set to 1 to abort on a violation instead of hitting a jassert, so an
+// automated run fails rather than carrying on.
+#ifndef CHANNELEQ_REALTIME_TRAP_ABORT
+ #define CHANNELEQ_REALTIME_TRAP_ABORT 0
+#endif
+
+/**
+    Marks the current thread as realtime for as long as the object lives.
+
+    While a thread is marked, any blocking enter() on a CheckedCriticalSection
+    is reported as a violation. processBlock() and ChannelEQConsole::process()
+    arm one on entry, so a lock that creeps into the audio path shows up the
+    first time a debug build of the plugin plays audio.
+
+    The plugin cannot see its allocations without replacing the host's
+    operator new, so those are caught by the tools: the benchmark's counting
+    operator new checks the trap and aborts on any violation in a realtime
+    row, and the batch renderer is built with
+    CHANNELEQ_REALTIME_TRAP_GLOBAL_NEW.
+
+    With CHANNELEQ_REALTIME_TRAP set to 0 this does nothing.
+*/
+class ScopedRealtimeTrap
+{
+public:
+    explicit ScopedRealtimeTrap(bool armed = true) noexcept;
+    ~ScopedRealtimeTrap() noexcept;
+
+    /** True while the current thread is inside an armed ScopedRealtimeTrap. */
+    static bool IsArmed() noexcept;
+
+    /** Reports operation as a violation if the current thread is armed. */
+    static void Check(const char *operation) noexcept;
+
+private:
+    bool Armed;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeTrap)
+};
+
+/**
+    A juce::CriticalSection whose blocking enter() is checked against
+    ScopedRealtimeTrap. tryEnter() never blocks, so it is not checked.
+*/
+class CheckedCriticalSection
+{
+public:
+    void enter() const noexcept
+    {
+        ScopedRealtimeTrap::Check("lock");
+        Lock.enter();
+    }
+
+    bool tryEnter() const noexcept  { return Lock.tryEnter(); }
+    void exit() const noexcept      { Lock.exit(); }
+
+    using ScopedLockType = juce::GenericScopedLock<CheckedCriticalSection>;
+    using ScopedTryLockType = juce::GenericScopedTryLock<CheckedCriticalSection>;
+
+private:
+    juce::CriticalSection Lock;
+};
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    ResponseCurveComponent.cpp
+    Frequency-response display for the editor.
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveComponent.h"
+
+ResponseCurveComponent::ResponseCurveComponent(ChannelEQAudioProcessor &processor) : AudioProcessor(processor)
+{
+    for (auto *Parameter : AudioProcessor.getParameters())
+        if (auto *ParameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(Parameter))
+            AudioProcessor.apvts.addParameterListener(ParameterWithID->paramID, this);
+
+    // Transparent, so the spectrum analyzer behind it shows through.
+    setBufferedToImage(true);
+
+    startTimerHz(30);
+}
+
+ResponseCurveComponent::~ResponseCurveComponent()
+{
+    for (auto *Parameter : AudioProcessor.getParameters())
+        if (auto *ParameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(Parameter))
+            AudioProcessor.apvts.removeParameterListener(ParameterWithID->paramID, this);
+}
+
+//==============================================================================
+void ResponseCurveComponent::paint(juce::Graphics &g)
+{
+    g.setColour(juce::Colours::orange);
+    g.drawRoundedRectangle(getLocalBounds().toFloat(), 4.0f, 1.0f);
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(ResponsePath, juce::PathStrokeType(2.0f));
+}
+
+void ResponseCurveComponent::resized()
+{
+    auto Width = (size_t) juce::jmax(0, getWidth());
+    Frequencies.resize(Width);
+    Magnitudes.resize(Width);
+
+    for (size_t x = 0; x < Width; ++x)
+        Frequencies[x] = juce::mapToLog10((double) x / (double) juce::jmax((size_t) 1, Width - 1), MinimumFrequency, MaximumFrequency);
+
+    UpdateResponse();
+    return;
+}
+
+//==============================================================================
+void ResponseCurveComponent::parameterChanged(const juce::String &parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    ParametersChanged = true;
+    return;
+}
+
+void ResponseCurveComponent::timerCallback()
+{
+    // Sample rate changes do not come through the parameter listener.
+    auto SampleRateChanged = AudioProcessor.getSampleRate() != DisplayedSampleRate;
+
+    if (ParametersChanged.exchange(false) || SampleRateChanged)
+        UpdateResponse();
+
+    return;
+}
+
+void ResponseCurveComponent::UpdateResponse()
+{
+    DisplayedSampleRate = AudioProcessor.getSampleRate();
+
+    if (Frequencies.empty())
+        return;
+
+    // Same design rate as the processor: the oversampled rate for the
+    // cascades, the highest one for the linear-phase kernel.
+    auto &Apvts = AudioProcessor.apvts;
+    auto LinearPhase = Apvts.getRawParameterValue("Phase")->load() > 0.5f;
+    auto Order = LinearPhase ? ChannelEQAudioProcessor::MaxOversamplingOrder
+                             : juce::jlimit(0, ChannelEQAudioProcessor::MaxOversamplingOrder, (int) Apvts.getRawParameterValue("Oversampling")->load());
+
+    auto SampleRate = DisplayedSampleRate > 0.0 ? DisplayedSampleRate : 48000.0;
+    auto Coefficients = Cache->GetChainCoefficients(GetChainSettings(Apvts), SampleRate * (1 << Order));
+
+    GetChainMagnitudes(Coefficients, Frequencies.data(), Magnitudes.data(), (int) Frequencies.size());
+
+    auto Bottom = (double) getHeight();
+
+    ResponsePath.clear();
+
+    for (size_t x = 0; x < Magnitudes.size(); ++x)
+    {
+        auto Level = juce::Decibels::gainToDecibels(Magnitudes[x], -2.0 * DisplayRangeInDB);
+        auto y = (float) juce::jmap(juce::jlimit(-DisplayRangeInDB, DisplayRangeInDB, Level), -DisplayRangeInDB, DisplayRangeInDB, Bottom, 0.0);
+
+        if (x == 0)
+            ResponsePath.startNewSubPath(0.0f, y);
+        else
+            ResponsePath.lineTo((float) x, y);
+    }
+
+    repaint();
+    return;
+}
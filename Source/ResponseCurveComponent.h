@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    ResponseCurveComponent.h
+    Frequency-response display for the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/**
+    Draws the magnitude response of the whole LowCut/Bell/HighCut chain, one
+    point per horizontal pixel on a log frequency axis, over the spectrum
+    analyzer.
+
+    The response is evaluated in one batch, and only after a parameter or the
+    sample rate has changed. The path is kept between repaints and the
+    component is buffered to an image, so a repaint for any other reason does
+    no filter maths. When nothing moves, the timer callback is a single
+    atomic load.
+*/
+class ResponseCurveComponent : public juce::Component,
+                               private juce::AudioProcessorValueTreeState::Listener,
+                               private juce::Timer
+{
+public:
+    explicit ResponseCurveComponent(ChannelEQAudioProcessor &processor);
+    ~ResponseCurveComponent() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+    static constexpr double MinimumFrequency = 20.0, MaximumFrequency = 20000.0;
+    static constexpr double DisplayRangeInDB = 24.0;
+
+private:
+    // May be called on the audio thread, so it only raises a flag.
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+    void timerCallback() override;
+
+    void UpdateResponse();
+
+    ChannelEQAudioProcessor &AudioProcessor;
+    juce::SharedResourcePointer<CoefficientCache> Cache;
+
+    std::atomic<bool> ParametersChanged {true};
+    double DisplayedSampleRate {0};
+
+    // One entry per horizontal pixel.
+    std::vector<double> Frequencies, Magnitudes;
+    juce::Path ResponsePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurveComponent)
+};
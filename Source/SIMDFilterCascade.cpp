@@ -0,0 +1,460 @@
+/*
+  ==============================================================================
+
+    SIMDFilterCascade.cpp
+    The LowCut/Bell/HighCut cascade for several channels at once, one channel
+    per SIMD lane.
+
+  ==============================================================================
+*/
+
+#include "SIMDFilterCascade.h"
+
+static const BiquadCoefficients IdentityCoefficients {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+template <typename SampleType>
+SIMDFilterCascade<SampleType>::SIMDFilterCascade()
+{
+    for (auto &section : Sections)
+        LoadSection(section, IdentityCoefficients);
+
+    reset();
+    UpdateActiveSlots();
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::prepare(int maximumBlockSize)
+{
+    Scratch.resize((size_t) juce::jmax(1, maximumBlockSize));
+    reset();
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::reset() noexcept
+{
+    for (auto &state : States)
+    {
+        state.s1 = Vec::expand(0);
+        state.s2 = Vec::expand(0);
+    }
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::setCoefficients(const ChainCoefficients &chainCoefficients) noexcept
+{
+    for (int Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        auto &Coefficients = GetSlotCoefficients(chainCoefficients, Slot);
+
+        LoadSection(Sections[(size_t) Slot], Coefficients);
+        NonNeutralLanes[(size_t) Slot] = IsNeutralSection(Coefficients) ? 0 : AllLanes;
+    }
+
+    for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+        SetLaneStages(Lane, chainCoefficients.NumLowCutStages, chainCoefficients.NumHighCutStages);
+
+    MidSide = chainCoefficients.Settings.MidSide.Enabled && NumLanes > SideLane;
+
+    if (MidSide)
+        LoadLane(SideLane, chainCoefficients, true);
+
+    UpdateActiveSlots();
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::setLaneCoefficients(size_t lane, const ChainCoefficients &chainCoefficients) noexcept
+{
+    jassert(lane < NumLanes);
+
+    LoadLane(lane, chainCoefficients, false);
+    UpdateActiveSlots();
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::setBellCoefficients(const BiquadCoefficients &coefficients) noexcept
+{
+    auto Neutral = IsNeutralSection(coefficients);
+
+    if (! MidSide)
+    {
+        LoadSection(Sections[(size_t) BellSlot], coefficients);
+        NonNeutralLanes[(size_t) BellSlot] = Neutral ? 0 : AllLanes;
+    }
+    else
+    {
+        // The dynamic Bell is Mid's alone; Side keeps its own Bell.
+        for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+        {
+            if (Lane == SideLane)
+                continue;
+
+            LoadSectionLane(Sections[(size_t) BellSlot], Lane, coefficients);
+
+            if (Neutral)
+                NonNeutralLanes[(size_t) BellSlot] &= ~(1u << Lane);
+            else
+                NonNeutralLanes[(size_t) BellSlot] |= 1u << Lane;
+        }
+    }
+
+    UpdateActiveSlots();
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::setBellModulated(bool isModulated) noexcept
+{
+    BellModulated = isModulated;
+    UpdateActiveSlots();
+    return;
+}
+
+template <typename SampleType>
+const BiquadCoefficients& SIMDFilterCascade<SampleType>::GetSlotCoefficients(const ChainCoefficients &chainCoefficients, int slot, bool side) noexcept
+{
+    auto NumLowCutStages = side ? chainCoefficients.NumSideLowCutStages : chainCoefficients.NumLowCutStages;
+    auto NumHighCutStages = side ? chainCoefficients.NumSideHighCutStages : chainCoefficients.NumHighCutStages;
+
+    if (! IsSlotUsed(slot, NumLowCutStages, NumHighCutStages))
+        return IdentityCoefficients;
+
+    if (slot < BellSlot)
+        return (side ? chainCoefficients.SideLowCut : chainCoefficients.LowCut)[(size_t) slot];
+
+    if (slot == BellSlot)
+        return side ? chainCoefficients.SideBell : chainCoefficients.Bell;
+
+    if (slot < FirstHighCutSlot)
+        return chainCoefficients.Bands[(size_t) (slot - FirstBandSlot)];
+
+    return (side ? chainCoefficients.SideHighCut : chainCoefficients.HighCut)[(size_t) (slot - FirstHighCutSlot)];
+}
+
+template <typename SampleType>
+bool SIMDFilterCascade<SampleType>::IsSlotUsed(int slot, int numLowCutStages, int numHighCutStages) noexcept
+{
+    if (slot < BellSlot)
+        return slot < numLowCutStages;
+
+    if (slot < FirstHighCutSlot)
+        return true;
+
+    return slot - FirstHighCutSlot < numHighCutStages;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::LoadSection(Section &section, const BiquadCoefficients &coefficients) noexcept
+{
+    section.b0 = Vec::expand(static_cast<SampleType>(coefficients[0]));
+    section.b1 = Vec::expand(static_cast<SampleType>(coefficients[1]));
+    section.b2 = Vec::expand(static_cast<SampleType>(coefficients[2]));
+    section.a1 = Vec::expand(static_cast<SampleType>(coefficients[3]));
+    section.a2 = Vec::expand(static_cast<SampleType>(coefficients[4]));
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::LoadSectionLane(Section &section, size_t lane, const BiquadCoefficients &coefficients) noexcept
+{
+    section.b0.set(lane, static_cast<SampleType>(coefficients[0]));
+    section.b1.set(lane, static_cast<SampleType>(coefficients[1]));
+    section.b2.set(lane, static_cast<SampleType>(coefficients[2]));
+    section.a1.set(lane, static_cast<SampleType>(coefficients[3]));
+    section.a2.set(lane, static_cast<SampleType>(coefficients[4]));
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::LoadLane(size_t lane, const ChainCoefficients &chainCoefficients, bool side) noexcept
+{
+    for (int Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        auto &Coefficients = GetSlotCoefficients(chainCoefficients, Slot, side);
+
+        LoadSectionLane(Sections[(size_t) Slot], lane, Coefficients);
+
+        if (IsNeutralSection(Coefficients))
+            NonNeutralLanes[(size_t) Slot] &= ~(1u << lane);
+        else
+            NonNeutralLanes[(size_t) Slot] |= 1u << lane;
+    }
+
+    if (side)
+        SetLaneStages(lane, chainCoefficients.NumSideLowCutStages, chainCoefficients.NumSideHighCutStages);
+    else
+        SetLaneStages(lane, chainCoefficients.NumLowCutStages, chainCoefficients.NumHighCutStages);
+
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::SetLaneStages(size_t lane, int numLowCutStages, int numHighCutStages) noexcept
+{
+    // A stage that was switched off holds whatever it had when it was last
+    // used; start it from silence instead.
+    for (int Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        auto WasUsed = IsSlotUsed(Slot, LaneLowCutStages[lane], LaneHighCutStages[lane]);
+
+        if (IsSlotUsed(Slot, numLowCutStages, numHighCutStages) && ! WasUsed)
+        {
+            States[(size_t) Slot].s1.set(lane, 0);
+            States[(size_t) Slot].s2.set(lane, 0);
+        }
+    }
+
+    LaneLowCutStages[lane] = numLowCutStages;
+    LaneHighCutStages[lane] = numHighCutStages;
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::UpdateActiveSlots() noexcept
+{
+    // Only slots where some lane does more than pass the signal through are
+    // run. Unused slots hold identity sections, so they drop out here too.
+    NumActiveSlots = 0;
+
+    for (int Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        auto Active = NonNeutralLanes[(size_t) Slot] != 0 || (Slot == BellSlot && BellModulated);
+
+        // A skipped slot kept whatever state it had; resume it from silence.
+        if (Active && ! SlotActive[(size_t) Slot])
+        {
+            States[(size_t) Slot].s1 = Vec::expand(0);
+            States[(size_t) Slot].s2 = Vec::expand(0);
+        }
+
+        SlotActive[(size_t) Slot] = Active;
+
+        if (Active)
+            ActiveSlots[(size_t) NumActiveSlots++] = Slot;
+    }
+
+    // Group the active slots by filter, so a cut runs exactly as many stages
+    // as its slope needs in one unrolled pass. The Bell and the bands form
+    // one filter, split into runs of at most MaxCutStages.
+    NumKernelCalls = 0;
+
+    for (int First = 0; First < NumActiveSlots;)
+    {
+        auto Filter = GetSlotFilter(ActiveSlots[(size_t) First]);
+        auto Last = First + 1;
+
+        while (Last < NumActiveSlots && Last - First < MaxCutStages && GetSlotFilter(ActiveSlots[(size_t) Last]) == Filter)
+            ++Last;
+
+        KernelCalls[(size_t) NumKernelCalls++] = { GetStageKernel(Last - First), First };
+        First = Last;
+    }
+
+    return;
+}
+
+template <typename SampleType>
+int SIMDFilterCascade<SampleType>::GetSlotFilter(int slot) noexcept
+{
+    if (slot < BellSlot)
+        return 0;
+
+    return slot < FirstHighCutSlot ? 1 : 2;
+}
+
+template <typename SampleType>
+typename SIMDFilterCascade<SampleType>::StageKernel SIMDFilterCascade<SampleType>::GetStageKernel(int numStages) noexcept
+{
+    // One entry per Slope, Slope_12 to Slope_60.
+    static constexpr StageKernel Kernels[] =
+    {
+        &ProcessStages<1>,
+        &ProcessStages<2>,
+        &ProcessStages<3>,
+        &ProcessStages<4>,
+        &ProcessStages<5>
+    };
+
+    static_assert(std::size(Kernels) == (size_t) MaxCutStages, "One kernel per cut stage count");
+
+    jassert(numStages >= 1 && numStages <= MaxCutStages);
+    return Kernels[numStages - 1];
+}
+
+//==============================================================================
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::process(const juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+    jassert(block.getNumChannels() <= NumLanes);
+    jassert(! Scratch.empty());
+
+    // Every section is neutral: the output is the input.
+    if (NumActiveSlots == 0)
+        return;
+
+    auto NumSamples = block.getNumSamples();
+    auto *Data = Scratch.data();
+
+    for (size_t Start = 0; Start < NumSamples; Start += Scratch.size())
+    {
+        auto Count = juce::jmin(Scratch.size(), NumSamples - Start);
+
+        Interleave(block, Start, Count);
+
+        // One pass per filter, with that filter's stages fused so each
+        // sample is loaded and stored once per filter rather than per stage.
+        for (int i = 0; i < NumKernelCalls; ++i)
+        {
+            auto &Call = KernelCalls[(size_t) i];
+            Call.Kernel(Sections.data(), States.data(), ActiveSlots.data() + Call.FirstActiveSlot, Data, Count);
+        }
+
+        Deinterleave(block, Start, Count);
+    }
+
+    SnapToZero();
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) noexcept
+{
+    auto NumChannels = block.getNumChannels();
+    auto *Frames = reinterpret_cast<SampleType*>(Scratch.data());
+    auto FirstLane = (size_t) 0;
+
+    if (MidSide && NumChannels > SideLane)
+    {
+        auto *Left = block.getChannelPointer(0) + startSample;
+        auto *Right = block.getChannelPointer(1) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            Frames[n * NumLanes] = (Left[n] + Right[n]) * static_cast<SampleType>(0.5);
+            Frames[n * NumLanes + SideLane] = (Left[n] - Right[n]) * static_cast<SampleType>(0.5);
+        }
+
+        FirstLane = 2;
+    }
+
+    for (size_t Lane = FirstLane; Lane < NumLanes; ++Lane)
+    {
+        // Unused lanes are fed silence so they never produce denormals or NaNs.
+        if (Lane >= NumChannels)
+        {
+            for (size_t n = 0; n < numSamples; ++n)
+                Frames[n * NumLanes + Lane] = 0;
+
+            continue;
+        }
+
+        auto *Channel = block.getChannelPointer(Lane) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            Frames[n * NumLanes + Lane] = Channel[n];
+    }
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::Deinterleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) const noexcept
+{
+    auto NumChannels = block.getNumChannels();
+    auto *Frames = reinterpret_cast<const SampleType*>(Scratch.data());
+    auto FirstLane = (size_t) 0;
+
+    if (MidSide && NumChannels > SideLane)
+    {
+        auto *Left = block.getChannelPointer(0) + startSample;
+        auto *Right = block.getChannelPointer(1) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto Mid = Frames[n * NumLanes];
+            auto Side = Frames[n * NumLanes + SideLane];
+
+            Left[n] = Mid + Side;
+            Right[n] = Mid - Side;
+        }
+
+        FirstLane = 2;
+    }
+
+    for (size_t Lane = FirstLane; Lane < NumChannels; ++Lane)
+    {
+        auto *Channel = block.getChannelPointer(Lane) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            Channel[n] = Frames[n * NumLanes + Lane];
+    }
+    return;
+}
+
+template <typename SampleType>
+template <int NumStages>
+void SIMDFilterCascade<SampleType>::ProcessStages(const Section *sections, State *states, const int *slots, Vec *data, size_t numSamples) noexcept
+{
+    // Coefficients and state are copied into locals so the compiler can keep
+    // them in registers across the sample loop.
+    Section Stage[NumStages];
+    Vec s1[NumStages], s2[NumStages];
+
+    for (int k = 0; k < NumStages; ++k)
+    {
+        Stage[k] = sections[slots[k]];
+        s1[k] = states[slots[k]].s1;
+        s2[k] = states[slots[k]].s2;
+    }
+
+    for (size_t n = 0; n < numSamples; ++n)
+    {
+        auto Input = data[n];
+
+        for (int k = 0; k < NumStages; ++k)
+        {
+            auto Output = (Input * Stage[k].b0) + s1[k];
+            s1[k] = (Input * Stage[k].b1) - (Output * Stage[k].a1) + s2[k];
+            s2[k] = (Input * Stage[k].b2) - (Output * Stage[k].a2);
+            Input = Output;
+        }
+
+        data[n] = Input;
+    }
+
+    for (int k = 0; k < NumStages; ++k)
+    {
+        states[slots[k]].s1 = s1[k];
+        states[slots[k]].s2 = s2[k];
+    }
+    return;
+}
+
+template <typename SampleType>
+void SIMDFilterCascade<SampleType>::SnapToZero() noexcept
+{
+    // Same threshold juce::dsp::IIR::Filter uses at the end of each block.
+    auto Snap = [](Vec &value)
+    {
+        for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+        {
+            auto Sample = value.get(Lane);
+            JUCE_SNAP_TO_ZERO(Sample);
+            value.set(Lane, Sample);
+        }
+    };
+
+    for (int i = 0; i < NumActiveSlots; ++i)
+    {
+        auto &state = States[(size_t) ActiveSlots[(size_t) i]];
+        Snap(state.s1);
+        Snap(state.s2);
+    }
+    return;
+}
+
+//==============================================================================
+template class SIMDFilterCascade<float>;
+template class SIMDFilterCascade<double>;
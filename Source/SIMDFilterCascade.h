@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    SIMDFilterCascade.h
+    The LowCut/Bell/HighCut cascade for several channels at once, one channel
+    per SIMD lane.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+
+/**
+    Runs up to NumLanes channels through one fused biquad cascade, with each
+    channel in its own lane of a juce::dsp::SIMDRegister.
+
+    The arithmetic is the same transposed direct form II, in the same
+    operation order, as juce::dsp::IIR::Filter. Output therefore matches the
+    scalar MonoChain path bit for bit, except where the compiler contracts
+    multiply-adds differently for the two. In that case the difference stays
+    below 1e-6 of full scale.
+
+    Coefficients and filter state live in fixed-size contiguous arrays. Only
+    prepare() allocates.
+
+    Instantiated for float and for double. A register holds half as many
+    doubles, so the double cascade runs two channels per group with SSE or
+    NEON and four with AVX.
+
+    In Mid/Side mode, lanes 0 and 1 carry Mid and Side instead of the left
+    and right channels. The encode is fused into the interleave and the
+    decode into the deinterleave, so the mode adds no pass over the block.
+
+    Each filter's active stages run through a kernel whose stage count is a
+    template argument, so a Slope_12 cut costs one section per sample and a
+    Slope_60 cut five, with no per-sample loop over unused slots. The kernels
+    are picked from a function-pointer table when the coefficients change,
+    and called once per block.
+*/
+template <typename SampleType>
+class SIMDFilterCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr size_t NumLanes = Vec::size();
+
+    // Slot layout: LowCut stages, the Bell, the bands, then the HighCut
+    // stages, all in one contiguous array. Off bands and 0 dB bells hold
+    // neutral sections, which are never run.
+    static constexpr int MaxCutStages = ChainCoefficients::MaxCutStages;
+    static constexpr int MaxBands = ChainSettings::MaxBands;
+    static constexpr int BellSlot = MaxCutStages;
+    static constexpr int FirstBandSlot = BellSlot + 1;
+    static constexpr int FirstHighCutSlot = FirstBandSlot + MaxBands;
+    static constexpr int NumSlots = FirstHighCutSlot + MaxCutStages;
+
+    //==============================================================================
+    SIMDFilterCascade();
+
+    /** Allocates the interleaving buffer. Not realtime safe. */
+    void prepare(int maximumBlockSize);
+
+    /** Clears the filter state of every lane. */
+    void reset() noexcept;
+
+    /** Loads the same coefficients into every lane. With
+        Settings.MidSide.Enabled, the Side lane gets the Side sections and
+        the first two channels of each block are processed as Mid and Side.
+    */
+    void setCoefficients(const ChainCoefficients &chainCoefficients) noexcept;
+
+    /** Loads coefficients into a single lane, leaving the other lanes alone.
+        Lanes may use different slopes; a lane that needs fewer stages than
+        its neighbours runs identity sections in the extra slots. Ignores the
+        Mid/Side settings.
+    */
+    void setLaneCoefficients(size_t lane, const ChainCoefficients &chainCoefficients) noexcept;
+
+    /** Replaces only the Bell, in every lane but Side's in Mid/Side mode.
+        Cheap enough for the dynamic Bell to call once per sub-block.
+    */
+    void setBellCoefficients(const BiquadCoefficients &coefficients) noexcept;
+
+    /** While set, the Bell runs even when it is neutral, so a gain that keeps
+        crossing 0 dB never restarts it from silence.
+    */
+    void setBellModulated(bool isModulated) noexcept;
+
+    //==============================================================================
+    /** Filters the block in place. It may have at most NumLanes channels. */
+    void process(const juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+private:
+    //==============================================================================
+    struct Section
+    {
+        Vec b0, b1, b2, a1, a2;
+    };
+
+    struct State
+    {
+        Vec s1, s2;
+    };
+
+    static constexpr auto AllLanes = (juce::uint32) ((1u << NumLanes) - 1);
+    static constexpr size_t SideLane = 1;
+
+    static const BiquadCoefficients& GetSlotCoefficients(const ChainCoefficients &chainCoefficients, int slot, bool side = false) noexcept;
+    static bool IsSlotUsed(int slot, int numLowCutStages, int numHighCutStages) noexcept;
+
+    static void LoadSection(Section &section, const BiquadCoefficients &coefficients) noexcept;
+    static void LoadSectionLane(Section &section, size_t lane, const BiquadCoefficients &coefficients) noexcept;
+
+    void LoadLane(size_t lane, const ChainCoefficients &chainCoefficients, bool side) noexcept;
+    void SetLaneStages(size_t lane, int numLowCutStages, int numHighCutStages) noexcept;
+    void UpdateActiveSlots() noexcept;
+
+    void Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) noexcept;
+    void Deinterleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) const noexcept;
+
+    using StageKernel = void (*)(const Section *sections, State *states, const int *slots, Vec *data, size_t numSamples) noexcept;
+
+    /** Runs NumStages sections, taken from the given slots, over the block
+        in a single pass with the stage loop unrolled.
+    */
+    template <int NumStages>
+    static void ProcessStages(const Section *sections, State *states, const int *slots, Vec *data, size_t numSamples) noexcept;
+
+    static StageKernel GetStageKernel(int numStages) noexcept;
+    static int GetSlotFilter(int slot) noexcept;
+
+    void SnapToZero() noexcept;
+
+    //==============================================================================
+    std::array<Section, NumSlots> Sections;
+    std::array<State, NumSlots> States;
+
+    std::array<int, NumLanes> LaneLowCutStages {}, LaneHighCutStages {};
+
+    // Per slot, a bit for each lane whose section actually changes the
+    // signal. Slots with no bits set (unused, or a 0 dB bell) are skipped,
+    // except for the Bell while it is modulated.
+    std::array<juce::uint32, NumSlots> NonNeutralLanes {};
+    std::array<bool, NumSlots> SlotActive {};
+    bool BellModulated {false}, MidSide {false};
+
+    std::array<int, NumSlots> ActiveSlots {};
+    int NumActiveSlots {0};
+
+    // One kernel call per run of at most MaxCutStages active slots from the
+    // same filter (LowCut, Bell and bands, HighCut), each starting at
+    // FirstActiveSlot in ActiveSlots.
+    struct KernelCall
+    {
+        StageKernel Kernel {nullptr};
+        int FirstActiveSlot {0};
+    };
+
+    std::array<KernelCall, NumSlots> KernelCalls {};
+    int NumKernelCalls {0};
+
+    std::vector<Vec> Scratch;
+
+    JUCE_LEAK_DETECTOR (SIMDFilterCascade)
+};
@@ -0,0 +1,396 @@
+/*
+  ==============================================================================
+
+    SVFFilterCascade.cpp
+    The LowCut/Bell/HighCut cascade built from TPT state-variable filters,
+    one channel per SIMD lane.
+
+  ==============================================================================
+*/
+
+#include "SVFFilterCascade.h"
+#include "BiquadDesign.h"
+
+template <typename SampleType>
+SVFFilterCascade<SampleType>::SVFFilterCascade()
+{
+    // Until the first setParameters(): every section passes the signal
+    // through, and only the Bell runs.
+    for (auto &section : Sections)
+        LoadSection(section, AllLanes, 0, 1, 1, 0, 0);
+
+    reset();
+
+    SlotLanes Active {};
+    Active[(size_t) BellSlot] = AllLanes;
+    SetActiveLanes(Active);
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::prepare(int maximumBlockSize)
+{
+    Scratch.resize((size_t) juce::jmax(1, maximumBlockSize));
+    reset();
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::reset() noexcept
+{
+    for (auto &state : States)
+    {
+        state.ic1eq = Vec::expand(0);
+        state.ic2eq = Vec::expand(0);
+    }
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::setParameters(const ChainSettings &chainSettings, double sampleRate) noexcept
+{
+    jassert(sampleRate > 0.0);
+
+    MidSide = chainSettings.MidSide.Enabled && NumLanes > SideLane;
+
+    SlotLanes Active {};
+
+    if (MidSide)
+    {
+        LoadChain(Active, AllLanes & ~(1u << SideLane), chainSettings, sampleRate);
+        LoadChain(Active, 1u << SideLane, GetSideSettings(chainSettings), sampleRate);
+    }
+    else
+    {
+        LoadChain(Active, AllLanes, chainSettings, sampleRate);
+    }
+
+    SetActiveLanes(Active);
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::LoadChain(SlotLanes &active, juce::uint32 lanes, const ChainSettings &chainSettings, double sampleRate) noexcept
+{
+    auto Pi = juce::MathConstants<double>::pi;
+    auto LowCutOrder = 2 * (chainSettings.LowCutSlope + 1);
+    auto HighCutOrder = 2 * (chainSettings.HighCutSlope + 1);
+
+    // High pass: input minus the band and low outputs.
+    auto LowCutG = (SampleType) std::tan(Pi * chainSettings.LowCutFreq / sampleRate);
+
+    for (int Stage = 0; Stage < LowCutOrder / 2; ++Stage)
+    {
+        auto k = (SampleType) 1 / GetButterworthQ<SampleType>(Stage, LowCutOrder);
+        LoadSection(Sections[(size_t) Stage], lanes, LowCutG, k, 1, -k, -1);
+        active[(size_t) Stage] |= lanes;
+    }
+
+    // Low pass: the low output alone.
+    auto HighCutG = (SampleType) std::tan(Pi * chainSettings.HighCutFreq / sampleRate);
+
+    for (int Stage = 0; Stage < HighCutOrder / 2; ++Stage)
+    {
+        auto k = (SampleType) 1 / GetButterworthQ<SampleType>(Stage, HighCutOrder);
+        LoadSection(Sections[(size_t) (FirstHighCutSlot + Stage)], lanes, HighCutG, k, 0, 0, 1);
+        active[(size_t) (FirstHighCutSlot + Stage)] |= lanes;
+    }
+
+    // The bell always runs, even at 0 dB. Skipping it would freeze its state,
+    // and a gain swept through 0 dB would then resume from stale values.
+    BandSettings Bell;
+    Bell.Type = BandType::Bell;
+    Bell.Freq = chainSettings.BellFreq;
+    Bell.GainInDB = chainSettings.BellGainInDB;
+    Bell.Q = chainSettings.BellQ;
+
+    LoadBandSection(Sections[(size_t) BellSlot], lanes, Bell, sampleRate);
+    active[(size_t) BellSlot] |= lanes;
+
+    for (int Band = 0; Band < MaxBands; ++Band)
+    {
+        auto &Settings = chainSettings.Bands[(size_t) Band];
+
+        if (Settings.Type == BandType::Off)
+            continue;
+
+        LoadBandSection(Sections[(size_t) (FirstBandSlot + Band)], lanes, Settings, sampleRate);
+        active[(size_t) (FirstBandSlot + Band)] |= lanes;
+    }
+
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::setBell(const BandSettings &bellSettings, double sampleRate) noexcept
+{
+    jassert(bellSettings.Type == BandType::Bell);
+
+    // The Bell slot is always active, so there is nothing else to update.
+    // The dynamic Bell is Mid's alone; Side keeps its own Bell.
+    auto Lanes = MidSide ? AllLanes & ~(1u << SideLane) : AllLanes;
+    LoadBandSection(Sections[(size_t) BellSlot], Lanes, bellSettings, sampleRate);
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::LoadSection(Section &section, juce::uint32 lanes, SampleType g, SampleType k, SampleType m0, SampleType m1, SampleType m2) noexcept
+{
+    auto a1 = (SampleType) 1 / ((SampleType) 1 + g * (g + k));
+    auto a2 = g * a1;
+    auto a3 = g * a2;
+
+    if (lanes == AllLanes)
+    {
+        section.a1 = Vec::expand(a1);
+        section.a2 = Vec::expand(a2);
+        section.a3 = Vec::expand(a3);
+        section.m0 = Vec::expand(m0);
+        section.m1 = Vec::expand(m1);
+        section.m2 = Vec::expand(m2);
+        return;
+    }
+
+    for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+    {
+        if ((lanes & (1u << Lane)) == 0)
+            continue;
+
+        section.a1.set(Lane, a1);
+        section.a2.set(Lane, a2);
+        section.a3.set(Lane, a3);
+        section.m0.set(Lane, m0);
+        section.m1.set(Lane, m1);
+        section.m2.set(Lane, m2);
+    }
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::LoadBandSection(Section &section, juce::uint32 lanes, const BandSettings &bandSettings, double sampleRate) noexcept
+{
+    // Simper's forms. Bell and shelves take A = sqrt(gain), as the RBJ
+    // designs do; the bell narrows its damping by A so its Q matches
+    // makePeakFilter(), and the shelves move g by sqrt(A) instead.
+    auto Frequency = bandSettings.Type == BandType::Bell || bandSettings.Type == BandType::LowShelf || bandSettings.Type == BandType::HighShelf
+                   ? juce::jmax(bandSettings.Freq, 2.0f) : bandSettings.Freq;
+
+    auto g = (SampleType) std::tan(juce::MathConstants<double>::pi * Frequency / sampleRate);
+    auto A = (SampleType) std::sqrt(juce::Decibels::decibelsToGain(bandSettings.GainInDB));
+    auto k = (SampleType) 1 / (SampleType) bandSettings.Q;
+
+    switch (bandSettings.Type)
+    {
+        case BandType::Bell:
+            k /= A;
+            LoadSection(section, lanes, g, k, 1, k * (A * A - 1), 0);
+            break;
+
+        case BandType::LowShelf:
+            LoadSection(section, lanes, g / std::sqrt(A), k, 1, k * (A - 1), A * A - 1);
+            break;
+
+        case BandType::HighShelf:
+            LoadSection(section, lanes, g * std::sqrt(A), k, A * A, k * (1 - A) * A, 1 - A * A);
+            break;
+
+        case BandType::Notch:       LoadSection(section, lanes, g, k, 1, -k, 0); break;
+        case BandType::LowCut:      LoadSection(section, lanes, g, k, 1, -k, -1); break;
+        case BandType::HighCut:     LoadSection(section, lanes, g, k, 0, 0, 1); break;
+        case BandType::Off:         LoadSection(section, lanes, 0, 1, 1, 0, 0); break;
+    }
+
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::SetActiveLanes(const SlotLanes &active) noexcept
+{
+    NumActiveSlots = 0;
+
+    for (int Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        auto Dropped = ActiveLanes[(size_t) Slot] & ~active[(size_t) Slot];
+        auto Started = active[(size_t) Slot] & ~ActiveLanes[(size_t) Slot];
+
+        // A lane that stops using a slot passes the signal through there, in
+        // case another lane still runs it, now or later.
+        if (Dropped != 0)
+            LoadSection(Sections[(size_t) Slot], Dropped, 0, 1, 1, 0, 0);
+
+        // A skipped slot kept whatever state it had; resume it from silence.
+        if (Started == AllLanes)
+        {
+            States[(size_t) Slot] = { Vec::expand(0), Vec::expand(0) };
+        }
+        else if (Started != 0)
+        {
+            for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+            {
+                if ((Started & (1u << Lane)) != 0)
+                {
+                    States[(size_t) Slot].ic1eq.set(Lane, 0);
+                    States[(size_t) Slot].ic2eq.set(Lane, 0);
+                }
+            }
+        }
+
+        ActiveLanes[(size_t) Slot] = active[(size_t) Slot];
+
+        if (active[(size_t) Slot] != 0)
+            ActiveSlots[(size_t) NumActiveSlots++] = Slot;
+    }
+
+    return;
+}
+
+//==============================================================================
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::process(const juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+    jassert(block.getNumChannels() <= NumLanes);
+    jassert(! Scratch.empty());
+
+    auto NumSamples = block.getNumSamples();
+    auto *Data = Scratch.data();
+
+    for (size_t Start = 0; Start < NumSamples; Start += Scratch.size())
+    {
+        auto Count = juce::jmin(Scratch.size(), NumSamples - Start);
+
+        Interleave(block, Start, Count);
+
+        for (int i = 0; i < NumActiveSlots; ++i)
+        {
+            auto Slot = (size_t) ActiveSlots[(size_t) i];
+            ProcessSection(Sections[Slot], States[Slot], Data, Count);
+        }
+
+        Deinterleave(block, Start, Count);
+    }
+
+    SnapToZero();
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) noexcept
+{
+    auto NumChannels = block.getNumChannels();
+    auto *Frames = reinterpret_cast<SampleType*>(Scratch.data());
+    auto FirstLane = (size_t) 0;
+
+    if (MidSide && NumChannels > SideLane)
+    {
+        auto *Left = block.getChannelPointer(0) + startSample;
+        auto *Right = block.getChannelPointer(1) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            Frames[n * NumLanes] = (Left[n] + Right[n]) * static_cast<SampleType>(0.5);
+            Frames[n * NumLanes + SideLane] = (Left[n] - Right[n]) * static_cast<SampleType>(0.5);
+        }
+
+        FirstLane = 2;
+    }
+
+    for (size_t Lane = FirstLane; Lane < NumLanes; ++Lane)
+    {
+        // Unused lanes are fed silence so they never produce denormals or NaNs.
+        if (Lane >= NumChannels)
+        {
+            for (size_t n = 0; n < numSamples; ++n)
+                Frames[n * NumLanes + Lane] = 0;
+
+            continue;
+        }
+
+        auto *Channel = block.getChannelPointer(Lane) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            Frames[n * NumLanes + Lane] = Channel[n];
+    }
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::Deinterleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) const noexcept
+{
+    auto NumChannels = block.getNumChannels();
+    auto *Frames = reinterpret_cast<const SampleType*>(Scratch.data());
+    auto FirstLane = (size_t) 0;
+
+    if (MidSide && NumChannels > SideLane)
+    {
+        auto *Left = block.getChannelPointer(0) + startSample;
+        auto *Right = block.getChannelPointer(1) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto Mid = Frames[n * NumLanes];
+            auto Side = Frames[n * NumLanes + SideLane];
+
+            Left[n] = Mid + Side;
+            Right[n] = Mid - Side;
+        }
+
+        FirstLane = 2;
+    }
+
+    for (size_t Lane = FirstLane; Lane < NumChannels; ++Lane)
+    {
+        auto *Channel = block.getChannelPointer(Lane) + startSample;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            Channel[n] = Frames[n * NumLanes + Lane];
+    }
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::ProcessSection(const Section &section, State &state, Vec *data, size_t numSamples) noexcept
+{
+    auto a1 = section.a1, a2 = section.a2, a3 = section.a3;
+    auto m0 = section.m0, m1 = section.m1, m2 = section.m2;
+    auto ic1eq = state.ic1eq, ic2eq = state.ic2eq;
+
+    for (size_t n = 0; n < numSamples; ++n)
+    {
+        auto v0 = data[n];
+        auto v3 = v0 - ic2eq;
+        auto v1 = (a1 * ic1eq) + (a2 * v3);
+        auto v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (v1 + v1) - ic1eq;
+        ic2eq = (v2 + v2) - ic2eq;
+        data[n] = (m0 * v0) + (m1 * v1) + (m2 * v2);
+    }
+
+    state.ic1eq = ic1eq;
+    state.ic2eq = ic2eq;
+    return;
+}
+
+template <typename SampleType>
+void SVFFilterCascade<SampleType>::SnapToZero() noexcept
+{
+    auto Snap = [](Vec &value)
+    {
+        for (size_t Lane = 0; Lane < NumLanes; ++Lane)
+        {
+            auto Sample = value.get(Lane);
+            JUCE_SNAP_TO_ZERO(Sample);
+            value.set(Lane, Sample);
+        }
+    };
+
+    for (int i = 0; i < NumActiveSlots; ++i)
+    {
+        auto &state = States[(size_t) ActiveSlots[(size_t) i]];
+        Snap(state.ic1eq);
+        Snap(state.ic2eq);
+    }
+    return;
+}
+
+//==============================================================================
+template class SVFFilterCascade<float>;
+template class SVFFilterCascade<double>;
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    SVFFilterCascade.h
+    The LowCut/Bell/HighCut cascade built from TPT state-variable filters,
+    one channel per SIMD lane.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainCoefficients.h"
+
+/**
+    The same LowCut/Bell/HighCut response as SIMDFilterCascade, from
+    topology-preserving-transform state-variable sections: the trapezoidal
+    SVF described by Zavalishin and Simper.
+
+    A biquad's coefficients all move when its frequency does. Its state
+    then no longer matches the new coefficients, so fast sweeps click or
+    zipper. An SVF's state is the integrators' output, which stays
+    meaningful as the frequency moves, so it can be modulated per sample.
+    Updating it is cheap as well: one tan() per filter and one division per
+    section, instead of a full redesign.
+
+    The cuts are Butterworth cascades with the same section Qs as the
+    biquad design. The bell, shelves, notch and band cuts are Simper's
+    forms of the RBJ filters that BiquadDesign implements. Magnitude
+    responses agree with the biquad path to rounding.
+
+    Every lane runs the same settings, except in Mid/Side mode: lanes 0 and
+    1 then carry Mid and Side, encoded and decoded inside the interleave as
+    in SIMDFilterCascade, and the Side lane runs the Side settings. Only
+    prepare() allocates.
+*/
+template <typename SampleType>
+class SVFFilterCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr size_t NumLanes = Vec::size();
+
+    // Same slot layout as SIMDFilterCascade.
+    static constexpr int MaxCutStages = ChainCoefficients::MaxCutStages;
+    static constexpr int MaxBands = ChainSettings::MaxBands;
+    static constexpr int BellSlot = MaxCutStages;
+    static constexpr int FirstBandSlot = BellSlot + 1;
+    static constexpr int FirstHighCutSlot = FirstBandSlot + MaxBands;
+    static constexpr int NumSlots = FirstHighCutSlot + MaxCutStages;
+
+    //==============================================================================
+    SVFFilterCascade();
+
+    /** Allocates the interleaving buffer. Not realtime safe. */
+    void prepare(int maximumBlockSize);
+
+    /** Clears the filter state of every lane. */
+    void reset() noexcept;
+
+    /** Retunes every section. Cheap enough to call every few samples while
+        parameters are moving, and keeps the filter state. Follows
+        chainSettings.MidSide.
+    */
+    void setParameters(const ChainSettings &chainSettings, double sampleRate) noexcept;
+
+    /** Retunes only the Bell, for the dynamic Bell's per sub-block updates.
+        In Mid/Side mode Side's Bell is left alone.
+    */
+    void setBell(const BandSettings &bellSettings, double sampleRate) noexcept;
+
+    //==============================================================================
+    /** Filters the block in place. It may have at most NumLanes channels. */
+    void process(const juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+private:
+    //==============================================================================
+    // Per section: the integrator gains, then the mix of input, band and low
+    // outputs that makes the low pass, high pass or bell.
+    struct Section
+    {
+        Vec a1, a2, a3;
+        Vec m0, m1, m2;
+    };
+
+    struct State
+    {
+        Vec ic1eq, ic2eq;
+    };
+
+    static constexpr auto AllLanes = (juce::uint32) ((1u << NumLanes) - 1);
+    static constexpr size_t SideLane = 1;
+
+    using SlotLanes = std::array<juce::uint32, NumSlots>;
+
+    /** Loads one chain's sections into the given lanes, and marks the slots
+        it uses for those lanes in active.
+    */
+    void LoadChain(SlotLanes &active, juce::uint32 lanes, const ChainSettings &chainSettings, double sampleRate) noexcept;
+
+    static void LoadSection(Section &section, juce::uint32 lanes, SampleType g, SampleType k, SampleType m0, SampleType m1, SampleType m2) noexcept;
+    static void LoadBandSection(Section &section, juce::uint32 lanes, const BandSettings &bandSettings, double sampleRate) noexcept;
+
+    void SetActiveLanes(const SlotLanes &active) noexcept;
+
+    void Interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) noexcept;
+    void Deinterleave(const juce::dsp::AudioBlock<SampleType> &block, size_t startSample, size_t numSamples) const noexcept;
+
+    static void ProcessSection(const Section &section, State &state, Vec *data, size_t numSamples) noexcept;
+
+    void SnapToZero() noexcept;
+
+    //==============================================================================
+    std::array<Section, NumSlots> Sections;
+    std::array<State, NumSlots> States;
+
+    // Per slot, a bit for each lane that uses it. A lane that does not holds
+    // a pass-through section there, so slots with no bits set (unused cut
+    // stages, Off bands) are skipped. The Bell always runs.
+    SlotLanes ActiveLanes {};
+    bool MidSide {false};
+
+    std::array<int, NumSlots> ActiveSlots {};
+    int NumActiveSlots {0};
+
+    std::vector<Vec> Scratch;
+
+    JUCE_LEAK_DETECTOR (SVFFilterCascade)
+};
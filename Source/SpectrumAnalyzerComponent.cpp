@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzerComponent.cpp
+    Pre/post EQ spectrum display, drawn behind the response curve.
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzerComponent.h"
+#include "ResponseCurveComponent.h"
+
+SpectrumAnalyzerComponent::SpectrumAnalyzerComponent(ChannelEQAudioProcessor &processor) : AudioProcessor(processor)
+{
+    PullBuffer.resize((size_t) AnalyzerFifo::DefaultCapacity);
+
+    for (auto &Analysis : Analyses)
+        Analysis.LevelsInDB.fill(FloorInDB);
+
+    setOpaque(true);
+
+    AudioProcessor.SetAnalyzerEnabled(true);
+    startTimerHz(RefreshRateHz);
+}
+
+SpectrumAnalyzerComponent::~SpectrumAnalyzerComponent()
+{
+    AudioProcessor.SetAnalyzerEnabled(false);
+}
+
+//==============================================================================
+void SpectrumAnalyzerComponent::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::grey.withAlpha(0.6f));
+    g.strokePath(Analyses[(size_t) ChannelEQAudioProcessor::AnalyzerTap::PreEQ].Spectrum, juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colours::skyblue.withAlpha(0.8f));
+    g.strokePath(Analyses[(size_t) ChannelEQAudioProcessor::AnalyzerTap::PostEQ].Spectrum, juce::PathStrokeType(1.0f));
+}
+
+void SpectrumAnalyzerComponent::resized()
+{
+    for (auto &Analysis : Analyses)
+        UpdatePath(Analysis);
+    return;
+}
+
+//==============================================================================
+void SpectrumAnalyzerComponent::timerCallback()
+{
+    auto Updated = false;
+
+    for (size_t Tap = 0; Tap < Analyses.size(); ++Tap)
+    {
+        auto &Analysis = Analyses[Tap];
+
+        if (! PullSamples(AudioProcessor.GetAnalyzerFifo((ChannelEQAudioProcessor::AnalyzerTap) Tap), Analysis))
+            continue;
+
+        Analyse(Analysis);
+        UpdatePath(Analysis);
+        Updated = true;
+    }
+
+    // Nothing arrives while the transport is stopped; keep the last frame.
+    if (Updated)
+        repaint();
+
+    return;
+}
+
+bool SpectrumAnalyzerComponent::PullSamples(AnalyzerFifo &fifo, Analysis &analysis)
+{
+    auto NumPulled = fifo.Pull(PullBuffer.data(), (int) PullBuffer.size());
+
+    // Only the newest FFTSize samples make it into the next frame.
+    for (int i = juce::jmax(0, NumPulled - FFTSize); i < NumPulled; ++i)
+    {
+        analysis.History[(size_t) analysis.HistoryPosition] = PullBuffer[(size_t) i];
+        analysis.HistoryPosition = (analysis.HistoryPosition + 1) % FFTSize;
+    }
+
+    return NumPulled > 0;
+}
+
+void SpectrumAnalyzerComponent::Analyse(Analysis &analysis)
+{
+    auto &History = analysis.History;
+    auto Oldest = History.begin() + analysis.HistoryPosition;
+
+    auto Next = std::copy(Oldest, History.end(), TransformBuffer.begin());
+    std::copy(History.begin(), Oldest, Next);
+    std::fill(TransformBuffer.begin() + FFTSize, TransformBuffer.end(), 0.0f);
+
+    Window.multiplyWithWindowingTable(TransformBuffer.data(), (size_t) FFTSize);
+    Transform.performFrequencyOnlyForwardTransform(TransformBuffer.data(), true);
+
+    // A full-scale sine reads 0 dB: the peak bin is FFTSize / 2 times the
+    // amplitude. Window is built normalised to unit mean, so the Hann window
+    // adds no loss of its own to undo.
+    auto Normalisation = 2.0f / (float) FFTSize;
+
+    for (size_t Bin = 0; Bin < analysis.LevelsInDB.size(); ++Bin)
+    {
+        auto Level = juce::Decibels::gainToDecibels(TransformBuffer[Bin] * Normalisation, FloorInDB);
+        analysis.LevelsInDB[Bin] = Smoothing * analysis.LevelsInDB[Bin] + (1.0f - Smoothing) * Level;
+    }
+    return;
+}
+
+void SpectrumAnalyzerComponent::UpdatePath(Analysis &analysis)
+{
+    auto Width = getWidth();
+    auto Height = (float) getHeight();
+
+    analysis.Spectrum.clear();
+
+    if (Width <= 1)
+        return;
+
+    auto SampleRate = AudioProcessor.getSampleRate() > 0.0 ? AudioProcessor.getSampleRate() : 48000.0;
+    auto NumBins = (int) analysis.LevelsInDB.size();
+
+    // Same log axis as the response curve drawn on top.
+    for (int x = 0; x < Width; ++x)
+    {
+        auto Frequency = juce::mapToLog10((double) x / (Width - 1), ResponseCurveComponent::MinimumFrequency, ResponseCurveComponent::MaximumFrequency);
+        auto Bin = juce::jlimit(0, NumBins - 1, juce::roundToInt(Frequency * FFTSize / SampleRate));
+        auto y = juce::jmap(analysis.LevelsInDB[(size_t) Bin], FloorInDB, 0.0f, Height, 0.0f);
+
+        if (x == 0)
+            analysis.Spectrum.startNewSubPath(0.0f, y);
+        else
+            analysis.Spectrum.lineTo((float) x, y);
+    }
+    return;
+}
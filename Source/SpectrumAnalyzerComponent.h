@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzerComponent.h
+    Pre/post EQ spectrum display, drawn behind the response curve.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/**
+    Pulls the processor's pre- and post-EQ taps on the message thread,
+    analyses them with a Hann-windowed juce::dsp::FFT, and draws both
+    smoothed spectra.
+
+    The processor's taps are switched on only while this component exists,
+    so a closed editor costs the audio thread nothing. Repaints are limited
+    to the timer rate and skipped when no new samples have arrived.
+*/
+class SpectrumAnalyzerComponent : public juce::Component,
+                                  private juce::Timer
+{
+public:
+    explicit SpectrumAnalyzerComponent(ChannelEQAudioProcessor &processor);
+    ~SpectrumAnalyzerComponent() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+    static constexpr int FFTOrder = 11;
+    static constexpr int FFTSize = 1 << FFTOrder;
+    static constexpr int RefreshRateHz = 30;
+
+    // Each frame keeps this much of the previous smoothed level, in dB.
+    static constexpr float Smoothing = 0.7f;
+    static constexpr float FloorInDB = -90.0f;
+
+private:
+    struct Analysis
+    {
+        // The last FFTSize samples of the tap, oldest at HistoryPosition.
+        std::array<float, FFTSize> History {};
+        int HistoryPosition {0};
+
+        std::array<float, FFTSize / 2> LevelsInDB {};
+        juce::Path Spectrum;
+    };
+
+    void timerCallback() override;
+
+    bool PullSamples(AnalyzerFifo &fifo, Analysis &analysis);
+    void Analyse(Analysis &analysis);
+    void UpdatePath(Analysis &analysis);
+
+    ChannelEQAudioProcessor &AudioProcessor;
+
+    juce::dsp::FFT Transform {FFTOrder};
+    juce::dsp::WindowingFunction<float> Window {(size_t) FFTSize, juce::dsp::WindowingFunction<float>::hann};
+
+    std::array<Analysis, 2> Analyses;
+    std::array<float, 2 * FFTSize> TransformBuffer {};
+    std::vector<float> PullBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzerComponent)
+};
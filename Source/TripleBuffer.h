@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Lock-free single-writer/single-reader handoff of a value type.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Classic triple buffer: the writer fills its private slot and publishes it
+    with a single atomic exchange, the reader picks up the most recent
+    published slot with another exchange. Neither side ever blocks, allocates
+    or waits for the other, which makes it safe to read on the audio thread.
+
+    There must be at most one writer thread and one reader thread at a time.
+*/
+template <typename ObjectType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    //==============================================================================
+    /** Writer side: the slot that will be handed over by the next Publish(). */
+    ObjectType& GetWriteBuffer() noexcept
+    {
+        return Buffers[(size_t) WriteIndex];
+    }
+
+    /** Writer side: makes the write slot visible to the reader. */
+    void Publish() noexcept
+    {
+        auto Previous = Shared.exchange(WriteIndex | NewDataFlag, std::memory_order_acq_rel);
+        WriteIndex = Previous & IndexMask;
+        return;
+    }
+
+    void Write(const ObjectType &newObject)
+    {
+        GetWriteBuffer() = newObject;
+        Publish();
+        return;
+    }
+
+    //==============================================================================
+    /** Reader side: swaps in the latest published slot. Returns false if nothing
+        new was published since the previous call.
+    */
+    bool Update() noexcept
+    {
+        if ((Shared.load(std::memory_order_relaxed) & NewDataFlag) == 0)
+            return false;
+
+        auto Previous = Shared.exchange(ReadIndex, std::memory_order_acq_rel);
+        ReadIndex = Previous & IndexMask;
+        return true;
+    }
+
+    /** Reader side: the slot obtained by the last successful Update(). */
+    const ObjectType& GetReadBuffer() const noexcept
+    {
+        return Buffers[(size_t) ReadIndex];
+    }
+
+private:
+    static constexpr int IndexMask = 3, NewDataFlag = 4;
+
+    std::array<ObjectType, 3> Buffers {};
+    int WriteIndex {0}, ReadIndex {1};
+    std::atomic<int> Shared {2};
+
+    JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
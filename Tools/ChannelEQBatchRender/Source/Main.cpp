@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+    Offline batch renderer: streams audio files through ChannelEQ.
+
+        ChannelEQBatchRender --state settings.bin --output-dir rendered
+                             [--threads N] [--chunk 4096] files...
+
+    The state file is a blob as written by getStateInformation(). Each
+    input file is rendered to a file of the same name and format in the
+    output directory.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../../Source/PluginProcessor.h"
+
+//==============================================================================
+struct RenderOptions
+{
+    juce::MemoryBlock State;
+    juce::File OutputDirectory;
+    int ChunkSize {4096};
+    int NumThreads {juce::SystemStats::getNumCpus()};
+};
+
+struct RenderResult
+{
+    bool Succeeded {false};
+    juce::String Message;
+    double AudioSeconds {0}, WallSeconds {0};
+};
+
+static juce::AudioChannelSet GetChannelSet(int numChannels)
+{
+    auto ChannelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    return ChannelSet.isDisabled() ? juce::AudioChannelSet::discreteChannels(numChannels) : ChannelSet;
+}
+
+static int ChooseBitDepth(juce::AudioFormat &format, int sourceBitDepth)
+{
+    auto Depths = format.getPossibleBitDepths();
+
+    if (Depths.contains(sourceBitDepth))
+        return sourceBitDepth;
+
+    return Depths.isEmpty() ? 16 : Depths.getLast();
+}
+
+static juce::File GetOutputFile(const juce::File &input, const RenderOptions &options)
+{
+    return options.OutputDirectory.getChildFile(input.getFileName());
+}
+
+//==============================================================================
+// Streams one file through its own processor instance, ChunkSize samples at
+// a time, so memory use does not depend on the length of the file.
+static RenderResult RenderFile(const juce::File &input, const RenderOptions &options)
+{
+    RenderResult Result;
+    auto Start = juce::Time::getMillisecondCounterHiRes();
+    auto Output = GetOutputFile(input, options);
+
+    // Rendering into the input's own directory would delete the source
+    // before it is read.
+    if (Output == input || Output.getLinkedTarget() == input.getLinkedTarget())
+    {
+        Result.Message = "output would overwrite its input " + input.getFullPathName();
+        return Result;
+    }
+
+    juce::AudioFormatManager Formats;
+    Formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> Reader(Formats.createReaderFor(input));
+    if (Reader == nullptr)
+    {
+        Result.Message = "cannot read " + input.getFullPathName();
+        return Result;
+    }
+
+    auto *Format = Formats.findFormatForFileExtension(input.getFileExtension());
+
+    Output.deleteFile();
+    std::unique_ptr<juce::OutputStream> Stream(Output.createOutputStream());
+
+    if (Format == nullptr || Stream == nullptr)
+    {
+        Result.Message = "cannot write " + Output.getFullPathName();
+        return Result;
+    }
+
+    auto NumChannels = (int) Reader->numChannels;
+    auto SampleRate = Reader->sampleRate;
+
+    std::unique_ptr<juce::AudioFormatWriter> Writer(Format->createWriterFor(Stream.get(), SampleRate, (unsigned int) NumChannels,
+                                                                              ChooseBitDepth(*Format, (int) Reader->bitsPerSample),
+                                                                              Reader->metadataValues, 0));
+    if (Writer == nullptr)
+    {
+        Result.Message = "unsupported output format for " + Output.getFullPathName();
+        return Result;
+    }
+
+    // The writer owns the stream from here on.
+    Stream.release();
+
+    ChannelEQAudioProcessor Processor;
+
+    juce::AudioProcessor::BusesLayout Layout;
+    Layout.inputBuses.add(GetChannelSet(NumChannels));
+    Layout.inputBuses.add(juce::AudioChannelSet::disabled());
+    Layout.outputBuses.add(GetChannelSet(NumChannels));
+
+    if (! Processor.setBusesLayout(Layout))
+    {
+        Result.Message = "unsupported channel count in " + input.getFullPathName();
+        return Result;
+    }
+
+    Processor.setNonRealtime(true);
+    Processor.setStateInformation(options.State.getData(), (int) options.State.getSize());
+    Processor.prepareToPlay(SampleRate, options.ChunkSize);
+
+    juce::AudioBuffer<float> Chunk(NumChannels, options.ChunkSize);
+    juce::MidiBuffer Midi;
+
+    // Latency is compensated by dropping the first LatencySamples of output
+    // and running the same number of samples of silence through at the end.
+    auto LatencySamples = (juce::int64) Processor.getLatencySamples();
+    auto TotalSamples = Reader->lengthInSamples;
+    juce::int64 SamplesToSkip = LatencySamples;
+
+    for (juce::int64 Position = 0; Position < TotalSamples + LatencySamples; Position += options.ChunkSize)
+    {
+        auto Count = (int) juce::jmin((juce::int64) options.ChunkSize, TotalSamples + LatencySamples - Position);
+
+        Chunk.clear();
+        if (Position < TotalSamples)
+            Reader->read(&Chunk, 0, (int) juce::jmin((juce::int64) Count, TotalSamples - Position), Position, true, true);
+
+        juce::AudioBuffer<float> Block(Chunk.getArrayOfWritePointers(), NumChannels, Count);
+        Processor.processBlock(Block, Midi);
+
+        auto Skip = (int) juce::jmin((juce::int64) Count, SamplesToSkip);
+        SamplesToSkip -= Skip;
+
+        if (Count > Skip && ! Writer->writeFromAudioSampleBuffer(Block, Skip, Count - Skip))
+        {
+            Result.Message = "write failed for " + Output.getFullPathName();
+            return Result;
+        }
+    }
+
+    Processor.releaseResources();
+    Writer.reset();
+
+    Result.Succeeded = true;
+    Result.AudioSeconds = (double) TotalSamples / SampleRate;
+    Result.WallSeconds = (juce::Time::getMillisecondCounterHiRes() - Start) / 1000.0;
+    return Result;
+}
+
+//==============================================================================
+static int PrintUsage()
+{
+    std::cerr << "usage: ChannelEQBatchRender --state settings.bin --output-dir dir [--threads N] [--chunk samples] files..." << std::endl;
+    return 1;
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Initialiser;
+
+    RenderOptions Options;
+    juce::Array<juce::File> Inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String Argument(argv[i]);
+        auto HasValue = i + 1 < argc;
+
+        if (Argument == "--state" && HasValue)
+        {
+            if (! juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]).loadFileAsData(Options.State))
+                return PrintUsage();
+        }
+        else if (Argument == "--output-dir" && HasValue)
+        {
+            Options.OutputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (Argument == "--threads" && HasValue)
+        {
+            Options.NumThreads = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (Argument == "--chunk" && HasValue)
+        {
+            Options.ChunkSize = juce::jmax(64, juce::String(argv[++i]).getIntValue());
+        }
+        else if (Argument.startsWith("--"))
+        {
+            return PrintUsage();
+        }
+        else
+        {
+            Inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(Argument));
+        }
+    }
+
+    if (Options.State.getSize() == 0 || Options.OutputDirectory == juce::File() || Inputs.isEmpty())
+        return PrintUsage();
+
+    // Outputs are named after their inputs, so two inputs with the same name
+    // would be rendered into one file by two jobs at once.
+    for (int Index = 1; Index < Inputs.size(); ++Index)
+    {
+        auto Output = GetOutputFile(Inputs.getReference(Index), Options);
+
+        for (int Other = 0; Other < Index; ++Other)
+        {
+            if (GetOutputFile(Inputs.getReference(Other), Options) == Output)
+            {
+                std::cerr << "error: " << Inputs.getReference(Other).getFullPathName() << " and "
+                          << Inputs.getReference(Index).getFullPathName() << " would both render to "
+                          << Output.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    Options.OutputDirectory.createDirectory();
+
+    // One job per file. Idle workers take the next file from the pool's
+    // shared queue, so long and short files balance out across threads.
+    std::vector<RenderResult> Results((size_t) Inputs.size());
+    juce::ThreadPool Pool(Options.NumThreads);
+    auto Start = juce::Time::getMillisecondCounterHiRes();
+
+    // The last job to finish wakes the main thread.
+    std::atomic<int> JobsLeft {Inputs.size()};
+    juce::WaitableEvent AllDone;
+
+    for (int Index = 0; Index < Inputs.size(); ++Index)
+    {
+        Pool.addJob([&Results, &Inputs, &Options, &JobsLeft, &AllDone, Index]
+        {
+            Results[(size_t) Index] = RenderFile(Inputs.getReference(Index), Options);
+
+            if (--JobsLeft == 0)
+                AllDone.signal();
+        });
+    }
+
+    AllDone.wait();
+
+    auto WallSeconds = (juce::Time::getMillisecondCounterHiRes() - Start) / 1000.0;
+    auto AudioSeconds = 0.0;
+    auto NumFailed = 0;
+
+    for (int Index = 0; Index < Inputs.size(); ++Index)
+    {
+        auto &Result = Results[(size_t) Index];
+
+        if (! Result.Succeeded)
+        {
+            std::cerr << "error: " << Result.Message << std::endl;
+            ++NumFailed;
+            continue;
+        }
+
+        AudioSeconds += Result.AudioSeconds;
+        std::cout << Inputs.getReference(Index).getFileName()
+                  << ": " << Result.AudioSeconds << " s audio in " << Result.WallSeconds << " s ("
+                  << Result.AudioSeconds / Result.WallSeconds << "x realtime)" << std::endl;
+    }
+
+    std::cout << "rendered " << Inputs.size() - NumFailed << " of " << Inputs.size() << " files, "
+              << AudioSeconds << " s audio in " << WallSeconds << " s on " << Options.NumThreads << " threads ("
+              << AudioSeconds / WallSeconds << "x realtime)" << std::endl;
+
+    return NumFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,1584 @@
+/*
+  ==============================================================================
+
+    Headless benchmarks for the ChannelEQ processing path.
+
+    Every result is written as one JSON object per line, so runs from
+    different releases can be diffed or loaded straight into a script:
+
+        ChannelEQBenchmark [--quick] [--verify] [--output results.jsonl]
+
+    --verify runs the accuracy gate instead of the benchmarks, and exits
+    non-zero if any processing path strays from the reference.
+
+    Every run also gates realtime safety: the trap is built in and aborts
+    the run if a realtime processBlock() or ChannelEQConsole::process()
+    allocates or takes a blocking lock.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/ChannelEQConsole.h"
+
+//==============================================================================
+// Allocation-counting hook. Only allocations made while CountAllocations is
+// set on the current thread are counted, so the background designer thread
+// and the benchmark's own bookkeeping do not show up. Every allocation is
+// also checked against the realtime trap, which processBlock() arms unless
+// rendering offline, so a realtime row that allocates aborts the run.
+static std::atomic<juce::int64> AllocationCount {0};
+static thread_local bool CountAllocations = false;
+
+static void CountAllocation() noexcept
+{
+    ScopedRealtimeTrap::Check("allocation");
+
+    if (CountAllocations)
+        AllocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    CountAllocation();
+    auto Alignment = juce::jmax((std::size_t) alignment, sizeof(void*));
+
+   #if JUCE_WINDOWS
+    return _aligned_malloc(size == 0 ? 1 : size, Alignment);
+   #else
+    void *Pointer = nullptr;
+    return posix_memalign(&Pointer, Alignment, size == 0 ? 1 : size) == 0 ? Pointer : nullptr;
+   #endif
+}
+
+static void FreeAligned(void *pointer) noexcept
+{
+   #if JUCE_WINDOWS
+    _aligned_free(pointer);
+   #else
+    std::free(pointer);
+   #endif
+}
+
+void* operator new (std::size_t size)
+{
+    CountAllocation();
+
+    if (auto *Pointer = std::malloc(size == 0 ? 1 : size))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    if (auto *Pointer = AllocateAligned(size, alignment))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+    return operator new (size, alignment);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept                               { CountAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept                             { CountAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return AllocateAligned(size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+
+void operator delete (void* pointer) noexcept                                               { std::free(pointer); }
+void operator delete[] (void* pointer) noexcept                                             { std::free(pointer); }
+void operator delete (void* pointer, std::size_t) noexcept                                  { std::free(pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept                                { std::free(pointer); }
+void operator delete (void* pointer, const std::nothrow_t&) noexcept                        { std::free(pointer); }
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept                      { std::free(pointer); }
+
+void operator delete (void* pointer, std::align_val_t) noexcept                             { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::align_val_t) noexcept                           { FreeAligned(pointer); }
+void operator delete (void* pointer, std::size_t, std::align_val_t) noexcept                { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::size_t, std::align_val_t) noexcept              { FreeAligned(pointer); }
+void operator delete (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept      { FreeAligned(pointer); }
+void operator delete[] (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept    { FreeAligned(pointer); }
+
+struct ScopedAllocationCounter
+{
+    ScopedAllocationCounter()  { CountAllocations = true; }
+    ~ScopedAllocationCounter() { CountAllocations = false; }
+};
+
+//==============================================================================
+/** One JSON object per line: {"benchmark":"process","sample_rate":48000,...} */
+class ResultWriter
+{
+public:
+    explicit ResultWriter(std::ostream &stream) : Stream(stream) {}
+
+    ResultWriter& Begin(const char *benchmark)
+    {
+        Line.str({});
+        Line << "{\"benchmark\":\"" << benchmark << "\"";
+        return *this;
+    }
+
+    ResultWriter& Add(const char *key, double value)
+    {
+        Line << ",\"" << key << "\":" << value;
+        return *this;
+    }
+
+    ResultWriter& Add(const char *key, const char *value)
+    {
+        Line << ",\"" << key << "\":\"" << value << "\"";
+        return *this;
+    }
+
+    void End()
+    {
+        Line << "}";
+        Stream << Line.str() << std::endl;
+    }
+
+private:
+    std::ostream &Stream;
+    std::ostringstream Line;
+};
+
+//==============================================================================
+static ChainSettings MakeRandomSettings(juce::Random &random)
+{
+    ChainSettings Settings;
+    Settings.LowCutFreq = 20.0f + random.nextFloat() * 480.0f;
+    Settings.HighCutFreq = 2000.0f + random.nextFloat() * 18000.0f;
+    Settings.BellFreq = 100.0f + random.nextFloat() * 9900.0f;
+    Settings.BellGainInDB = -12.0f + random.nextFloat() * 24.0f;
+    Settings.BellQ = 0.3f + random.nextFloat() * 4.0f;
+    Settings.LowCutSlope = static_cast<Slope>(random.nextInt(5));
+    Settings.HighCutSlope = static_cast<Slope>(random.nextInt(5));
+    return Settings;
+}
+
+static ChainSettings MakeSlopeSettings(Slope slope)
+{
+    ChainSettings Settings;
+    Settings.LowCutFreq = 80.0f;
+    Settings.HighCutFreq = 12000.0f;
+    Settings.BellFreq = 1000.0f;
+    Settings.BellGainInDB = 6.0f;
+    Settings.BellQ = 1.0f;
+    Settings.LowCutSlope = slope;
+    Settings.HighCutSlope = slope;
+    return Settings;
+}
+
+static void SetParameter(ChannelEQAudioProcessor &processor, const juce::String &parameterID, float value)
+{
+    auto *Parameter = processor.apvts.getParameter(parameterID);
+    Parameter->setValueNotifyingHost(Parameter->convertTo0to1(value));
+    return;
+}
+
+static void SetParameters(ChannelEQAudioProcessor &processor, const ChainSettings &settings)
+{
+    SetParameter(processor, "LowCut Freq", settings.LowCutFreq);
+    SetParameter(processor, "HighCut Freq", settings.HighCutFreq);
+    SetParameter(processor, "Bell Freq", settings.BellFreq);
+    SetParameter(processor, "Bell Gain", settings.BellGainInDB);
+    SetParameter(processor, "Bell Width (Q)", settings.BellQ);
+    SetParameter(processor, "LowCut Slope", (float) settings.LowCutSlope);
+    SetParameter(processor, "HighCut Slope", (float) settings.HighCutSlope);
+    return;
+}
+
+template <typename SampleType>
+static void FillWithNoise(juce::AudioBuffer<SampleType> &buffer, juce::Random &random)
+{
+    for (int Channel = 0; Channel < buffer.getNumChannels(); ++Channel)
+    {
+        auto *Data = buffer.getWritePointer(Channel);
+
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+            Data[n] = (SampleType) (random.nextFloat() * 2.0f - 1.0f);
+    }
+    return;
+}
+
+template <typename SampleType>
+static void CopyBuffer(juce::AudioBuffer<SampleType> &destination, const juce::AudioBuffer<SampleType> &source)
+{
+    for (int Channel = 0; Channel < source.getNumChannels(); ++Channel)
+        destination.copyFrom(Channel, 0, source, Channel, 0, source.getNumSamples());
+    return;
+}
+
+static double TicksToNanoseconds(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9;
+}
+
+template <typename Callback>
+static double MeasureSeconds(Callback &&callback)
+{
+    auto Start = juce::Time::getHighResolutionTicks();
+    callback();
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Start);
+}
+
+//==============================================================================
+struct BenchmarkOptions
+{
+    int SamplesPerConfiguration {1 << 20};
+    int DesignIterations {2000};
+    int ConsoleBlocks {2000};
+
+    int VerifyGridPoints {5};
+    double VerifySignalSeconds {0.5};
+    std::vector<double> VerifySampleRates {44100.0, 48000.0, 96000.0};
+};
+
+//==============================================================================
+// processBlock cost for one stereo instance. "static" holds every parameter
+// still; "automated" moves Bell Freq and LowCut Freq on every block. The
+// processor stays in realtime mode, as in a live host: each change is
+// designed on the designer's path between blocks, outside the timing, and
+// processBlock picks it up and ramps with sub-block redesigns. With
+// nonRealtime the row is "automated_offline" instead: the processor renders
+// offline and designs inside processBlock, which is the most the audio
+// thread can ever be asked to do, but not what a live callback does.
+//
+// oversamplingOrder selects the "Oversampling" choice. Each factor roughly
+// doubles the cascade's cost and adds the half-band up/down filters on
+// top, so compare cpu_load across the oversampling rows before enabling it
+// on every track.
+//
+// topology selects the "Topology" choice. Under automation the biquad path
+// redesigns every 32 samples while the SVF path only retunes, every 4.
+//
+// SampleType picks the host's processing precision. A register holds half
+// as many doubles, but a stereo pair still fits in one, so the double rows
+// measure the wider arithmetic rather than extra passes.
+template <typename SampleType = float>
+static void RunProcessBenchmark(ResultWriter &writer, const BenchmarkOptions &options,
+                                double sampleRate, int blockSize, Slope slope, bool automated,
+                                int oversamplingOrder = 0, FilterTopology topology = FilterTopology::Biquad,
+                                bool nonRealtime = false)
+{
+    ChannelEQAudioProcessor Processor;
+    Processor.setNonRealtime(nonRealtime);
+
+    auto Settings = MakeSlopeSettings(slope);
+    SetParameters(Processor, Settings);
+    SetParameter(Processor, "Oversampling", (float) oversamplingOrder);
+    SetParameter(Processor, "Topology", (float) topology);
+
+    if (std::is_same<SampleType, double>::value)
+        Processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+    Processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::Random Random(blockSize);
+    juce::MidiBuffer Midi;
+    juce::AudioBuffer<SampleType> Source(2, blockSize), Work(2, blockSize);
+    FillWithNoise(Source, Random);
+
+    auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+
+    // Settle the smoothers and the background designer first.
+    for (int Block = 0; Block < 32; ++Block)
+    {
+        CopyBuffer(Work, Source);
+        Processor.processBlock(Work, Midi);
+    }
+
+    juce::int64 TotalTicks = 0, WorstTicks = 0;
+    AllocationCount = 0;
+
+    for (int Block = 0; Block < NumBlocks; ++Block)
+    {
+        if (automated)
+        {
+            auto Phase = (float) Block / 64.0f;
+            SetParameter(Processor, "Bell Freq", Settings.BellFreq * std::pow(2.0f, std::sin(Phase)));
+            SetParameter(Processor, "LowCut Freq", Settings.LowCutFreq * std::pow(2.0f, std::cos(Phase)));
+
+            // A live designer keeps up with one change per block.
+            if (! nonRealtime)
+                Processor.DesignPendingChanges();
+        }
+
+        CopyBuffer(Work, Source);
+
+        auto Start = juce::Time::getHighResolutionTicks();
+        {
+            ScopedAllocationCounter Counter;
+            Processor.processBlock(Work, Midi);
+        }
+        auto Ticks = juce::Time::getHighResolutionTicks() - Start;
+
+        TotalTicks += Ticks;
+        WorstTicks = juce::jmax(WorstTicks, Ticks);
+    }
+
+    auto NumSamples = (double) NumBlocks * blockSize;
+    auto NanosecondsPerSample = TicksToNanoseconds(TotalTicks) / NumSamples;
+    auto DeadlineNanoseconds = 1.0e9 * blockSize / sampleRate;
+
+    writer.Begin("process")
+          .Add("mode", ! automated ? "static" : nonRealtime ? "automated_offline" : "automated")
+          .Add("realtime", nonRealtime ? 0 : 1)
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("slope_db_per_oct", 12 * (slope + 1))
+          .Add("channels", 2)
+          .Add("oversampling", 1 << oversamplingOrder)
+          .Add("topology", topology == FilterTopology::SVF ? "svf" : "biquad")
+          .Add("precision", std::is_same<SampleType, double>::value ? "double" : "float")
+          .Add("latency_samples", Processor.getLatencySamples())
+          .Add("ns_per_sample", NanosecondsPerSample)
+          .Add("worst_block_ns", TicksToNanoseconds(WorstTicks))
+          .Add("cpu_load", TicksToNanoseconds(TotalTicks) / NumBlocks / DeadlineNanoseconds)
+          .Add("allocations_per_block", (double) AllocationCount.load() / NumBlocks)
+          .End();
+
+    Processor.releaseResources();
+}
+
+//==============================================================================
+// The Bell in dynamic mode against the same settings with it static, on the
+// internal sidechain and on a stereo external one. The input swells and
+// fades, so the envelope keeps crossing the threshold and the Bell keeps
+// being redesigned; the ratios are the per-instance cost of the dynamics.
+static void RunDynamicBellBenchmark(ResultWriter &writer, const BenchmarkOptions &options,
+                                    double sampleRate, int blockSize, FilterTopology topology)
+{
+    juce::MidiBuffer Midi;
+
+    auto Measure = [&](bool dynamic, bool externalSidechain)
+    {
+        ChannelEQAudioProcessor Processor;
+
+        if (externalSidechain)
+        {
+            auto Layout = Processor.getBusesLayout();
+            Layout.inputBuses.getReference(1) = juce::AudioChannelSet::stereo();
+            Processor.setBusesLayout(Layout);
+        }
+
+        SetParameters(Processor, MakeSlopeSettings(Slope_24));
+        SetParameter(Processor, "Topology", (float) topology);
+        SetParameter(Processor, "Bell Dynamics", dynamic ? 1.0f : 0.0f);
+        SetParameter(Processor, "Bell Sidechain", externalSidechain ? 1.0f : 0.0f);
+        SetParameter(Processor, "Bell Threshold", -30.0f);
+        SetParameter(Processor, "Bell Attack", 1.0f);
+        SetParameter(Processor, "Bell Release", 20.0f);
+        Processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::Random Random(blockSize);
+        auto NumChannels = Processor.getTotalNumInputChannels();
+        juce::AudioBuffer<float> Source(NumChannels, blockSize), Work(NumChannels, blockSize);
+
+        auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+        juce::int64 TotalTicks = 0;
+
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            FillWithNoise(Source, Random);
+            Source.applyGain(0.5f + 0.5f * std::sin((float) Block / 8.0f));
+            CopyBuffer(Work, Source);
+
+            auto Start = juce::Time::getHighResolutionTicks();
+            Processor.processBlock(Work, Midi);
+            TotalTicks += juce::Time::getHighResolutionTicks() - Start;
+        }
+
+        Processor.releaseResources();
+        return TicksToNanoseconds(TotalTicks) / ((double) NumBlocks * blockSize);
+    };
+
+    auto StaticNanoseconds = Measure(false, false);
+    auto InternalNanoseconds = Measure(true, false);
+    auto ExternalNanoseconds = Measure(true, true);
+
+    writer.Begin("dynamic_bell")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("topology", topology == FilterTopology::SVF ? "svf" : "biquad")
+          .Add("static_ns_per_sample", StaticNanoseconds)
+          .Add("internal_ns_per_sample", InternalNanoseconds)
+          .Add("external_ns_per_sample", ExternalNanoseconds)
+          .Add("internal_ratio", InternalNanoseconds / StaticNanoseconds)
+          .Add("external_ratio", ExternalNanoseconds / StaticNanoseconds)
+          .End();
+}
+
+//==============================================================================
+// The same stereo instance in Left/Right and in Mid/Side mode, with Side
+// on different cuts and Bell from Mid. The encode and decode ride along
+// with the cascade's interleave, and Mid and Side share one register, so
+// mid_side_ratio should stay close to 1.
+static void RunMidSideBenchmark(ResultWriter &writer, const BenchmarkOptions &options,
+                                double sampleRate, int blockSize, FilterTopology topology)
+{
+    juce::MidiBuffer Midi;
+
+    auto Measure = [&](bool midSide)
+    {
+        ChannelEQAudioProcessor Processor;
+
+        SetParameters(Processor, MakeSlopeSettings(Slope_24));
+        SetParameter(Processor, "Topology", (float) topology);
+        SetParameter(Processor, "Stereo Mode", midSide ? 1.0f : 0.0f);
+        SetParameter(Processor, "Side LowCut Freq", 150.0f);
+        SetParameter(Processor, "Side LowCut Slope", (float) Slope_48);
+        SetParameter(Processor, "Side Bell Freq", 6000.0f);
+        SetParameter(Processor, "Side Bell Gain", 3.0f);
+        Processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::Random Random(blockSize);
+        juce::AudioBuffer<float> Source(2, blockSize), Work(2, blockSize);
+        FillWithNoise(Source, Random);
+
+        auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+        juce::int64 TotalTicks = 0;
+
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            CopyBuffer(Work, Source);
+
+            auto Start = juce::Time::getHighResolutionTicks();
+            Processor.processBlock(Work, Midi);
+            TotalTicks += juce::Time::getHighResolutionTicks() - Start;
+        }
+
+        Processor.releaseResources();
+        return TicksToNanoseconds(TotalTicks) / ((double) NumBlocks * blockSize);
+    };
+
+    auto LeftRightNanoseconds = Measure(false);
+    auto MidSideNanoseconds = Measure(true);
+
+    writer.Begin("mid_side")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("topology", topology == FilterTopology::SVF ? "svf" : "biquad")
+          .Add("left_right_ns_per_sample", LeftRightNanoseconds)
+          .Add("mid_side_ns_per_sample", MidSideNanoseconds)
+          .Add("mid_side_ratio", MidSideNanoseconds / LeftRightNanoseconds)
+          .End();
+}
+
+//==============================================================================
+// MIDI program changes every 32 blocks, cycling through the factory bank,
+// against the same run with none. A switch swaps in a coefficient set
+// designed ahead of time and runs both programs' cascades for the
+// crossfade, so switch_block_ns should stay within a few times a plain
+// block and allocations_per_block at zero.
+static void RunProgramChangeBenchmark(ResultWriter &writer, const BenchmarkOptions &options, double sampleRate, int blockSize)
+{
+    ChannelEQAudioProcessor Processor;
+    Processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::Random Random(blockSize);
+    juce::MidiBuffer Midi;
+    juce::AudioBuffer<float> Source(2, blockSize), Work(2, blockSize);
+    FillWithNoise(Source, Random);
+
+    // Let the designer thread build every preset's coefficient set.
+    CopyBuffer(Work, Source);
+    Processor.processBlock(Work, Midi);
+    juce::Thread::sleep(100);
+
+    auto NumPrograms = Processor.getNumPrograms();
+    auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+
+    auto Measure = [&](bool switching, juce::int64 &switchTicks, int &numSwitches)
+    {
+        juce::int64 TotalTicks = 0;
+        AllocationCount = 0;
+
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            auto Switch = switching && Block % 32 == 0;
+            Midi.clear();
+
+            if (Switch)
+                Midi.addEvent(juce::MidiMessage::programChange(1, (Block / 32) % NumPrograms), 0);
+
+            CopyBuffer(Work, Source);
+
+            auto Start = juce::Time::getHighResolutionTicks();
+            {
+                ScopedAllocationCounter Counter;
+                Processor.processBlock(Work, Midi);
+            }
+            auto Ticks = juce::Time::getHighResolutionTicks() - Start;
+
+            TotalTicks += Ticks;
+
+            if (Switch)
+            {
+                switchTicks += Ticks;
+                ++numSwitches;
+            }
+        }
+        return TotalTicks;
+    };
+
+    juce::int64 SwitchTicks = 0;
+    int NumSwitches = 0;
+
+    auto SteadyTicks = Measure(false, SwitchTicks, NumSwitches);
+    auto SwitchingTicks = Measure(true, SwitchTicks, NumSwitches);
+    auto Allocations = AllocationCount.load();
+
+    auto NumSamples = (double) NumBlocks * blockSize;
+
+    writer.Begin("program_change")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("programs", NumPrograms)
+          .Add("steady_ns_per_sample", TicksToNanoseconds(SteadyTicks) / NumSamples)
+          .Add("switching_ns_per_sample", TicksToNanoseconds(SwitchingTicks) / NumSamples)
+          .Add("block_ns", TicksToNanoseconds(SteadyTicks) / NumBlocks)
+          .Add("switch_block_ns", TicksToNanoseconds(SwitchTicks) / juce::jmax(1, NumSwitches))
+          .Add("allocations_per_block", (double) Allocations / NumBlocks)
+          .End();
+
+    Processor.releaseResources();
+}
+
+//==============================================================================
+// The stereo SIMDFilterCascade on its own, with the Bell at 0 dB so only the
+// two cuts run. Each cut runs a kernel with exactly its slope's stage count,
+// so ns_per_stage should stay roughly flat while ns_per_sample grows with
+// the slope.
+//
+// numBands switches that many bands on as bells; the rest stay Off and
+// should cost nothing.
+static void RunCascadeBenchmark(ResultWriter &writer, const BenchmarkOptions &options,
+                                double sampleRate, int blockSize, Slope slope, int numBands = 0)
+{
+    auto Settings = MakeSlopeSettings(slope);
+    Settings.BellGainInDB = 0.0f;
+
+    for (int Band = 0; Band < numBands; ++Band)
+    {
+        Settings.Bands[(size_t) Band].Type = BandType::Bell;
+        Settings.Bands[(size_t) Band].Freq = 100.0f * std::pow(2.0f, (float) Band);
+        Settings.Bands[(size_t) Band].GainInDB = -3.0f;
+    }
+
+    SIMDFilterCascade<float> Cascade;
+    Cascade.prepare(blockSize);
+    Cascade.setCoefficients(DesignChainCoefficients(Settings, sampleRate));
+
+    juce::Random Random(blockSize);
+    juce::AudioBuffer<float> Buffer(2, blockSize);
+    FillWithNoise(Buffer, Random);
+
+    auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+    auto NumStages = 2 * (slope + 1) + numBands;
+
+    auto Seconds = MeasureSeconds([&]
+    {
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            // The cascades are stable, so feeding the output back in keeps
+            // the signal bounded without a copy per block.
+            juce::dsp::AudioBlock<float> Audio(Buffer);
+            Cascade.process(Audio);
+        }
+    });
+
+    auto NanosecondsPerSample = Seconds * 1.0e9 / ((double) NumBlocks * blockSize);
+
+    writer.Begin("cascade")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("slope_db_per_oct", 12 * (slope + 1))
+          .Add("bands", numBands)
+          .Add("stages", NumStages)
+          .Add("ns_per_sample", NanosecondsPerSample)
+          .Add("ns_per_stage", NanosecondsPerSample / NumStages)
+          .End();
+}
+
+//==============================================================================
+// Linear-phase mode for one stereo instance, per kernel length and FFT
+// partition size: the latency/CPU trade-off SetLinearPhaseOptions() offers.
+static void RunLinearPhaseBenchmark(ResultWriter &writer, const BenchmarkOptions &options,
+                                    double sampleRate, int blockSize, int kernelLength, int partitionSize)
+{
+    ChannelEQAudioProcessor Processor;
+
+    SetParameters(Processor, MakeSlopeSettings(Slope_24));
+    SetParameter(Processor, "Phase", 1.0f);
+    Processor.SetLinearPhaseOptions(kernelLength, partitionSize);
+    Processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::Random Random(partitionSize);
+    juce::MidiBuffer Midi;
+    juce::AudioBuffer<float> Source(2, blockSize), Work(2, blockSize);
+    FillWithNoise(Source, Random);
+
+    auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+
+    juce::int64 TotalTicks = 0, WorstTicks = 0;
+    AllocationCount = 0;
+
+    for (int Block = 0; Block < NumBlocks; ++Block)
+    {
+        CopyBuffer(Work, Source);
+
+        auto Start = juce::Time::getHighResolutionTicks();
+        {
+            ScopedAllocationCounter Counter;
+            Processor.processBlock(Work, Midi);
+        }
+        auto Ticks = juce::Time::getHighResolutionTicks() - Start;
+
+        TotalTicks += Ticks;
+        WorstTicks = juce::jmax(WorstTicks, Ticks);
+    }
+
+    auto DeadlineNanoseconds = 1.0e9 * blockSize / sampleRate;
+
+    writer.Begin("linear_phase")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("kernel_length", kernelLength)
+          .Add("partition_size", partitionSize)
+          .Add("latency_samples", Processor.getLatencySamples())
+          .Add("ns_per_sample", TicksToNanoseconds(TotalTicks) / ((double) NumBlocks * blockSize))
+          .Add("worst_block_ns", TicksToNanoseconds(WorstTicks))
+          .Add("cpu_load", TicksToNanoseconds(TotalTicks) / NumBlocks / DeadlineNanoseconds)
+          .Add("allocations_per_block", (double) AllocationCount.load() / NumBlocks)
+          .End();
+
+    Processor.releaseResources();
+}
+
+//==============================================================================
+// Cost of the spectrum analyzer's pre/post taps on the audio thread: the
+// same stereo instance with the taps off and on. The FIFOs are drained
+// between blocks, outside the timed region, as an open editor would.
+static void RunAnalyzerTapBenchmark(ResultWriter &writer, const BenchmarkOptions &options, double sampleRate, int blockSize)
+{
+    ChannelEQAudioProcessor Processor;
+    SetParameters(Processor, MakeSlopeSettings(Slope_24));
+    Processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::Random Random(blockSize);
+    juce::MidiBuffer Midi;
+    juce::AudioBuffer<float> Source(2, blockSize), Work(2, blockSize);
+    FillWithNoise(Source, Random);
+
+    std::vector<float> Drain((size_t) AnalyzerFifo::DefaultCapacity);
+    auto NumBlocks = juce::jmax(64, options.SamplesPerConfiguration / blockSize);
+
+    auto Measure = [&](bool tapEnabled)
+    {
+        Processor.SetAnalyzerEnabled(tapEnabled);
+
+        juce::int64 TotalTicks = 0;
+        AllocationCount = 0;
+
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            CopyBuffer(Work, Source);
+
+            auto Start = juce::Time::getHighResolutionTicks();
+            {
+                ScopedAllocationCounter Counter;
+                Processor.processBlock(Work, Midi);
+            }
+            TotalTicks += juce::Time::getHighResolutionTicks() - Start;
+
+            for (auto Tap : { ChannelEQAudioProcessor::AnalyzerTap::PreEQ, ChannelEQAudioProcessor::AnalyzerTap::PostEQ })
+                Processor.GetAnalyzerFifo(Tap).Pull(Drain.data(), (int) Drain.size());
+        }
+
+        return TicksToNanoseconds(TotalTicks) / ((double) NumBlocks * blockSize);
+    };
+
+    auto TapOff = Measure(false);
+    auto TapOn = Measure(true);
+    auto TapAllocations = AllocationCount.load();
+
+    writer.Begin("analyzer_tap")
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("channels", 2)
+          .Add("tap_off_ns_per_sample", TapOff)
+          .Add("tap_on_ns_per_sample", TapOn)
+          .Add("overhead_ns_per_sample", TapOn - TapOff)
+          .Add("overhead_percent", 100.0 * (TapOn - TapOff) / TapOff)
+          .Add("allocations_per_block", (double) TapAllocations / NumBlocks)
+          .End();
+
+    Processor.releaseResources();
+}
+
+//==============================================================================
+// The work UpdateFilters() does per parameter change: a full uncached design
+// of the chain, and the same request answered by the shared cache.
+static void RunDesignBenchmark(ResultWriter &writer, const BenchmarkOptions &options, double sampleRate, Slope slope)
+{
+    auto Settings = MakeSlopeSettings(slope);
+    juce::SharedResourcePointer<CoefficientCache> Cache;
+
+    ChainCoefficients Sink;
+
+    AllocationCount = 0;
+    auto DesignSeconds = MeasureSeconds([&]
+    {
+        ScopedAllocationCounter Counter;
+
+        for (int i = 0; i < options.DesignIterations; ++i)
+        {
+            // Nudge the frequency so nothing can be hoisted out of the loop.
+            Settings.BellFreq = 1000.0f + (float) (i & 255);
+            Sink = DesignChainCoefficients(Settings, sampleRate);
+        }
+    });
+    auto DesignAllocations = AllocationCount.load();
+
+    Cache->GetChainCoefficients(Settings, sampleRate);
+
+    auto CachedSeconds = MeasureSeconds([&]
+    {
+        for (int i = 0; i < options.DesignIterations; ++i)
+            Sink = Cache->GetChainCoefficients(Settings, sampleRate);
+    });
+
+    juce::ignoreUnused(Sink);
+
+    writer.Begin("update_filters")
+          .Add("sample_rate", sampleRate)
+          .Add("slope_db_per_oct", 12 * (slope + 1))
+          .Add("design_ns", DesignSeconds * 1.0e9 / options.DesignIterations)
+          .Add("design_allocations", (double) DesignAllocations / options.DesignIterations)
+          .Add("cached_ns", CachedSeconds * 1.0e9 / options.DesignIterations)
+          .End();
+}
+
+//==============================================================================
+// N separate mono ChannelEQAudioProcessor instances against one
+// ChannelEQConsole running the same N strips.
+static void RunConsoleBenchmark(ResultWriter &writer, const BenchmarkOptions &options, int numStrips, double sampleRate, int blockSize)
+{
+    juce::Random Random(numStrips);
+    juce::MidiBuffer Midi;
+
+    std::vector<ChainSettings> Settings;
+    for (int Strip = 0; Strip < numStrips; ++Strip)
+        Settings.push_back(MakeRandomSettings(Random));
+
+    juce::AudioProcessor::BusesLayout MonoLayout;
+    MonoLayout.inputBuses.add(juce::AudioChannelSet::mono());
+    MonoLayout.inputBuses.add(juce::AudioChannelSet::disabled());
+    MonoLayout.outputBuses.add(juce::AudioChannelSet::mono());
+
+    std::vector<std::unique_ptr<ChannelEQAudioProcessor>> Instances;
+    for (int Strip = 0; Strip < numStrips; ++Strip)
+    {
+        auto Instance = std::make_unique<ChannelEQAudioProcessor>();
+        Instance->setBusesLayout(MonoLayout);
+        SetParameters(*Instance, Settings[(size_t) Strip]);
+        Instance->prepareToPlay(sampleRate, blockSize);
+        Instances.push_back(std::move(Instance));
+    }
+
+    ChannelEQConsole Console;
+    Console.prepare(sampleRate, blockSize, numStrips);
+    for (int Strip = 0; Strip < numStrips; ++Strip)
+        Console.setStripSettings(Strip, Settings[(size_t) Strip]);
+
+    juce::AudioBuffer<float> Source(numStrips, blockSize), Work(numStrips, blockSize);
+    FillWithNoise(Source, Random);
+
+    auto NumBlocks = options.ConsoleBlocks;
+
+    auto InstanceSeconds = MeasureSeconds([&]
+    {
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            CopyBuffer(Work, Source);
+
+            for (int Strip = 0; Strip < numStrips; ++Strip)
+            {
+                juce::AudioBuffer<float> StripBuffer(Work.getArrayOfWritePointers() + Strip, 1, blockSize);
+                Instances[(size_t) Strip]->processBlock(StripBuffer, Midi);
+            }
+        }
+    });
+
+    auto ConsoleSeconds = MeasureSeconds([&]
+    {
+        for (int Block = 0; Block < NumBlocks; ++Block)
+        {
+            CopyBuffer(Work, Source);
+            Console.process(Work);
+        }
+    });
+
+    auto NumSamples = (double) numStrips * blockSize * NumBlocks;
+
+    writer.Begin("console")
+          .Add("strips", numStrips)
+          .Add("sample_rate", sampleRate)
+          .Add("block_size", blockSize)
+          .Add("instances_ns_per_sample", InstanceSeconds * 1.0e9 / NumSamples)
+          .Add("console_ns_per_sample", ConsoleSeconds * 1.0e9 / NumSamples)
+          .Add("speedup", InstanceSeconds / ConsoleSeconds)
+          .End();
+
+    for (auto &Instance : Instances)
+        Instance->releaseResources();
+}
+
+//==============================================================================
+// Accuracy gate for every processing path (--verify). Each path renders an
+// impulse, a log sweep and noise for a grid of settings, and is compared
+// with a double-precision reference of the same ChainSettings. The
+// reference is designed by JUCE's own FilterDesign and IIR::Coefficients
+// rather than BiquadDesign, so a mistake shared by the designers cannot
+// hide, and runs each section through a juce::dsp::IIR::Filter<double>.
+//
+// "legacy" is the original LeftChain/RightChain setup: a float MonoChain
+// per channel with JUCE's float designs. It had no bands, so on settings
+// with bands a float ReferenceChain stands in for it.
+//
+// Each row also records ns_per_sample, so a faster path comes with the
+// proof that it is still correct.
+template <typename SampleType>
+class ReferenceChain
+{
+public:
+    ReferenceChain(const ChainSettings &settings, double sampleRate)
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+        std::vector<typename Coefficients::Ptr> Sections;
+
+        auto LowCut = juce::dsp::FilterDesign<SampleType>::designIIRHighpassHighOrderButterworthMethod(settings.LowCutFreq, sampleRate,
+                                                                                                       2 * (settings.LowCutSlope + 1));
+        for (int i = 0; i < LowCut.size(); ++i)
+            Sections.push_back(LowCut[i]);
+
+        Sections.push_back(Coefficients::makePeakFilter(sampleRate, settings.BellFreq, settings.BellQ,
+                                                        juce::Decibels::decibelsToGain((SampleType) settings.BellGainInDB)));
+
+        for (auto &Band : settings.Bands)
+        {
+            auto GainFactor = juce::Decibels::decibelsToGain((SampleType) Band.GainInDB);
+
+            switch (Band.Type)
+            {
+                case BandType::Bell:        Sections.push_back(Coefficients::makePeakFilter(sampleRate, Band.Freq, Band.Q, GainFactor)); break;
+                case BandType::LowShelf:    Sections.push_back(Coefficients::makeLowShelf(sampleRate, Band.Freq, Band.Q, GainFactor)); break;
+                case BandType::HighShelf:   Sections.push_back(Coefficients::makeHighShelf(sampleRate, Band.Freq, Band.Q, GainFactor)); break;
+                case BandType::Notch:       Sections.push_back(Coefficients::makeNotch(sampleRate, Band.Freq, Band.Q)); break;
+                case BandType::LowCut:      Sections.push_back(Coefficients::makeHighPass(sampleRate, Band.Freq, Band.Q)); break;
+                case BandType::HighCut:     Sections.push_back(Coefficients::makeLowPass(sampleRate, Band.Freq, Band.Q)); break;
+                case BandType::Off:         break;
+            }
+        }
+
+        auto HighCut = juce::dsp::FilterDesign<SampleType>::designIIRLowpassHighOrderButterworthMethod(settings.HighCutFreq, sampleRate,
+                                                                                                       2 * (settings.HighCutSlope + 1));
+        for (int i = 0; i < HighCut.size(); ++i)
+            Sections.push_back(HighCut[i]);
+
+        Filters.resize(Sections.size());
+
+        for (size_t i = 0; i < Sections.size(); ++i)
+            Filters[i].coefficients = Sections[i];
+    }
+
+    void Reset()
+    {
+        for (auto &Section : Filters)
+            Section.reset();
+        return;
+    }
+
+    void Process(SampleType *samples, int numSamples)
+    {
+        for (auto &Section : Filters)
+            for (int n = 0; n < numSamples; ++n)
+                samples[n] = Section.processSample(samples[n]);
+        return;
+    }
+
+private:
+    std::vector<BasicFilter<SampleType>> Filters;
+};
+
+template <int Index>
+static void ConfigureLegacyStage(CutFilter &cut, const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> &sections)
+{
+    auto Active = Index < sections.size();
+    cut.template setBypassed<Index>(! Active);
+
+    if (Active)
+        cut.template get<Index>().coefficients = sections[Index];
+    return;
+}
+
+static void ConfigureLegacyCut(CutFilter &cut, const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> &sections)
+{
+    ConfigureLegacyStage<0>(cut, sections);
+    ConfigureLegacyStage<1>(cut, sections);
+    ConfigureLegacyStage<2>(cut, sections);
+    ConfigureLegacyStage<3>(cut, sections);
+    ConfigureLegacyStage<4>(cut, sections);
+    return;
+}
+
+static void ConfigureLegacyChain(MonoChain &chain, const ChainSettings &settings, double sampleRate)
+{
+    ConfigureLegacyCut(chain.get<ChainPositions::LowCut>(),
+                       juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(settings.LowCutFreq, sampleRate,
+                                                                                                   2 * (settings.LowCutSlope + 1)));
+
+    auto GainFactor = juce::Decibels::decibelsToGain(settings.BellGainInDB);
+    chain.get<ChainPositions::Bell>().coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, settings.BellFreq, settings.BellQ, GainFactor);
+
+    ConfigureLegacyCut(chain.get<ChainPositions::HighCut>(),
+                       juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(settings.HighCutFreq, sampleRate,
+                                                                                                  2 * (settings.HighCutSlope + 1)));
+    return;
+}
+
+//==============================================================================
+struct VerifyErrors
+{
+    // Largest deviation from the reference response, at third-octave
+    // frequencies where the reference is above VerifyResponseFloorInDB.
+    double MagnitudeInDB {0}, PhaseInDegrees {0};
+
+    // Largest output sample difference on the sweep and the noise,
+    // relative to the input's RMS.
+    double DifferenceInDB {-300};
+};
+
+static constexpr double VerifyResponseFloorInDB = -60.0;
+static constexpr int VerifyBlockSize = 256;
+
+// Impulse responses are rendered until the reference has decayed this far,
+// within 4096 to 65536 samples.
+static constexpr double VerifyTailDecayInDB = 120.0;
+
+// The float paths round every coefficient and state to 24 bits, so they are
+// held to what float can do; the double paths should match the reference
+// to within the designers' rounding.
+static const VerifyErrors FloatTolerances {0.05, 0.5, -70.0};
+static const VerifyErrors DoubleTolerances {1.0e-4, 1.0e-3, -120.0};
+
+// A float path also passes wherever it stays within the legacy chain's error
+// on the same settings plus LegacyMargin: the cascades only promise to be no
+// worse than what they replaced, and a steep low cut far below the sample
+// rate is beyond float either way. The margin only covers two float designs
+// of the same filter rounding differently; an engine that doubles the
+// legacy error still fails.
+static const VerifyErrors LegacyMargin {0.01, 0.1, 1.0};
+
+static VerifyErrors GetAllowedErrors(const VerifyErrors &tolerances, const VerifyErrors *legacy)
+{
+    if (legacy == nullptr)
+        return tolerances;
+
+    return { juce::jmax(tolerances.MagnitudeInDB, legacy->MagnitudeInDB + LegacyMargin.MagnitudeInDB),
+             juce::jmax(tolerances.PhaseInDegrees, legacy->PhaseInDegrees + LegacyMargin.PhaseInDegrees),
+             juce::jmax(tolerances.DifferenceInDB, legacy->DifferenceInDB + LegacyMargin.DifferenceInDB) };
+}
+
+static bool IsWithin(const VerifyErrors &errors, const VerifyErrors &allowed)
+{
+    return errors.MagnitudeInDB <= allowed.MagnitudeInDB
+        && errors.PhaseInDegrees <= allowed.PhaseInDegrees
+        && errors.DifferenceInDB <= allowed.DifferenceInDB;
+}
+
+// H(f) of a truncated impulse response. Both sides of a comparison are cut
+// at the same length, so the truncation cancels out.
+static std::complex<double> GetResponseAt(const double *impulse, int length, double frequency, double sampleRate)
+{
+    auto Step = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+    std::complex<double> Phasor {1.0, 0.0}, Sum {0.0, 0.0};
+
+    for (int n = 0; n < length; ++n)
+    {
+        Sum += impulse[n] * Phasor;
+        Phasor *= Step;
+    }
+    return Sum;
+}
+
+struct VerifySignals
+{
+    juce::AudioBuffer<double> Impulse, Sweep, Noise;
+    double InputRMS {0};
+};
+
+static VerifySignals MakeVerifySignals(int impulseLength, int signalLength, double sampleRate)
+{
+    VerifySignals Signals;
+    Signals.Impulse.setSize(1, impulseLength);
+    Signals.Sweep.setSize(1, signalLength);
+    Signals.Noise.setSize(1, signalLength);
+
+    Signals.Impulse.clear();
+    Signals.Impulse.setSample(0, 0, 1.0);
+
+    // Exponential sweep over 20 Hz to 20 kHz, or to just below Nyquist.
+    auto Start = 20.0, End = juce::jmin(20000.0, 0.45 * sampleRate);
+    auto Rate = std::log(End / Start) / signalLength;
+    auto *Sweep = Signals.Sweep.getWritePointer(0);
+
+    for (int n = 0; n < signalLength; ++n)
+        Sweep[n] = 0.5 * std::sin(juce::MathConstants<double>::twoPi * Start / sampleRate * (std::exp(Rate * n) - 1.0) / Rate);
+
+    juce::Random Random(signalLength);
+    auto *Noise = Signals.Noise.getWritePointer(0);
+
+    for (int n = 0; n < signalLength; ++n)
+        Noise[n] = 0.5 * (Random.nextDouble() * 2.0 - 1.0);
+
+    // The louder of the two, so the bound is never loosened by a quiet input.
+    Signals.InputRMS = juce::jmax(Signals.Sweep.getRMSLevel(0, 0, signalLength), Signals.Noise.getRMSLevel(0, 0, signalLength));
+    return Signals;
+}
+
+// Runs input through processBlock in VerifyBlockSize blocks, the same signal
+// on both channels, and returns the stereo output in double.
+template <typename SampleType, typename Callback>
+static juce::AudioBuffer<double> RenderVerifySignal(const juce::AudioBuffer<double> &input, Callback &&processBlock, double &seconds)
+{
+    auto NumSamples = input.getNumSamples();
+    juce::AudioBuffer<double> Output(2, NumSamples);
+    juce::AudioBuffer<SampleType> Block(2, VerifyBlockSize);
+    auto *Input = input.getReadPointer(0);
+
+    for (int Start = 0; Start < NumSamples; Start += VerifyBlockSize)
+    {
+        auto Length = juce::jmin(VerifyBlockSize, NumSamples - Start);
+        Block.setSize(2, Length, false, false, true);
+
+        for (int Channel = 0; Channel < 2; ++Channel)
+            for (int n = 0; n < Length; ++n)
+                Block.setSample(Channel, n, (SampleType) Input[Start + n]);
+
+        seconds += MeasureSeconds([&] { processBlock(Block); });
+
+        for (int Channel = 0; Channel < 2; ++Channel)
+            for (int n = 0; n < Length; ++n)
+                Output.setSample(Channel, Start + n, (double) Block.getSample(Channel, n));
+    }
+    return Output;
+}
+
+// Compares a path's renders of the three signals with the reference's.
+// reset is called before each, so every signal starts from silence.
+template <typename SampleType, typename ResetCallback, typename ProcessCallback>
+static VerifyErrors MeasureVerifyErrors(const VerifySignals &signals, const VerifySignals &expected, double sampleRate,
+                                        ResetCallback &&reset, ProcessCallback &&processBlock, double &seconds)
+{
+    VerifyErrors Errors;
+
+    reset();
+    double ImpulseSeconds = 0;
+    auto Impulse = RenderVerifySignal<SampleType>(signals.Impulse, processBlock, ImpulseSeconds);
+    auto ImpulseLength = Impulse.getNumSamples();
+    auto *ExpectedImpulse = expected.Impulse.getReadPointer(0);
+
+    for (auto Frequency = 20.0; Frequency <= juce::jmin(20000.0, 0.45 * sampleRate); Frequency *= std::pow(2.0, 1.0 / 3.0))
+    {
+        auto Expected = GetResponseAt(ExpectedImpulse, ImpulseLength, Frequency, sampleRate);
+
+        if (juce::Decibels::gainToDecibels(std::abs(Expected), -300.0) < VerifyResponseFloorInDB)
+            continue;
+
+        for (int Channel = 0; Channel < 2; ++Channel)
+        {
+            auto Response = GetResponseAt(Impulse.getReadPointer(Channel), ImpulseLength, Frequency, sampleRate);
+            auto Ratio = Response / Expected;
+
+            Errors.MagnitudeInDB = juce::jmax(Errors.MagnitudeInDB, std::abs(juce::Decibels::gainToDecibels(std::abs(Ratio), -300.0)));
+            Errors.PhaseInDegrees = juce::jmax(Errors.PhaseInDegrees, std::abs(juce::radiansToDegrees(std::arg(Ratio))));
+        }
+    }
+
+    auto LargestDifference = 0.0;
+
+    for (auto Signal : { &VerifySignals::Sweep, &VerifySignals::Noise })
+    {
+        reset();
+        auto Output = RenderVerifySignal<SampleType>(signals.*Signal, processBlock, seconds);
+        auto *Expected = (expected.*Signal).getReadPointer(0);
+
+        for (int Channel = 0; Channel < 2; ++Channel)
+            for (int n = 0; n < Output.getNumSamples(); ++n)
+                LargestDifference = juce::jmax(LargestDifference, std::abs(Output.getSample(Channel, n) - Expected[n]));
+    }
+
+    Errors.DifferenceInDB = juce::Decibels::gainToDecibels(LargestDifference / signals.InputRMS, -300.0);
+    return Errors;
+}
+
+//==============================================================================
+struct VerifyCase
+{
+    const char *Name;
+    ChainSettings Settings;
+};
+
+// Values spread evenly over a parameter's normalised range, skew included,
+// exactly as CreateParameterLayout() defines it.
+static std::vector<float> GetParameterGrid(ChannelEQAudioProcessor &processor, const juce::String &parameterID, int numPoints)
+{
+    auto *Parameter = processor.apvts.getParameter(parameterID);
+    std::vector<float> Values;
+
+    for (int i = 0; i < numPoints; ++i)
+        Values.push_back(Parameter->convertFrom0to1((float) i / (float) (numPoints - 1)));
+
+    return Values;
+}
+
+// Every slope on both cuts, the Bell over frequency, gain and width, and
+// each band type on the first band. Everything else stays at the layout's
+// defaults: cuts wide open, Bell at 0 dB, bands Off.
+static std::vector<VerifyCase> MakeVerifyCases(int numPoints)
+{
+    ChannelEQAudioProcessor Defaults;
+    auto Flat = GetChainSettings(Defaults.apvts);
+    std::vector<VerifyCase> Cases;
+
+    // Stored as the processor will run them, after the parameters have
+    // snapped each value to its step.
+    auto Add = [&](const char *name, const ChainSettings &settings)
+    {
+        SetChainSettings(Defaults.apvts, settings);
+        Cases.push_back({name, GetChainSettings(Defaults.apvts)});
+    };
+
+    auto Freqs = GetParameterGrid(Defaults, "Bell Freq", numPoints);
+    auto Gains = GetParameterGrid(Defaults, "Bell Gain", numPoints);
+    auto Qs = GetParameterGrid(Defaults, "Bell Width (Q)", numPoints);
+
+    for (auto SlopeSetting : { Slope_12, Slope_24, Slope_36, Slope_48, Slope_60 })
+    {
+        for (auto Freq : GetParameterGrid(Defaults, "LowCut Freq", numPoints))
+        {
+            auto Settings = Flat;
+            Settings.LowCutFreq = Freq;
+            Settings.LowCutSlope = SlopeSetting;
+            Add("low_cut", Settings);
+        }
+
+        for (auto Freq : GetParameterGrid(Defaults, "HighCut Freq", numPoints))
+        {
+            auto Settings = Flat;
+            Settings.HighCutFreq = Freq;
+            Settings.HighCutSlope = SlopeSetting;
+            Add("high_cut", Settings);
+        }
+    }
+
+    for (auto Freq : Freqs)
+        for (auto Gain : Gains)
+            for (auto Q : Qs)
+            {
+                auto Settings = Flat;
+                Settings.BellFreq = Freq;
+                Settings.BellGainInDB = Gain;
+                Settings.BellQ = Q;
+                Add("bell", Settings);
+            }
+
+    if (ChainSettings::MaxBands > 0)
+    {
+        for (auto Type : { BandType::Bell, BandType::LowShelf, BandType::HighShelf, BandType::Notch, BandType::LowCut, BandType::HighCut })
+        {
+            // Notch and the cuts have no gain, so sweep their Q instead.
+            auto HasGain = Type == BandType::Bell || Type == BandType::LowShelf || Type == BandType::HighShelf;
+
+            for (auto Freq : Freqs)
+                for (auto Value : HasGain ? Gains : Qs)
+                {
+                    auto Settings = Flat;
+                    auto &Band = Settings.Bands[0];
+                    Band.Type = Type;
+                    Band.Freq = Freq;
+                    (HasGain ? Band.GainInDB : Band.Q) = Value;
+                    Add("band", Settings);
+                }
+        }
+    }
+
+    return Cases;
+}
+
+static bool HasBands(const ChainSettings &settings)
+{
+    return std::any_of(settings.Bands.begin(), settings.Bands.end(), [](const BandSettings &band) { return band.Type != BandType::Off; });
+}
+
+//==============================================================================
+struct VerifyPath
+{
+    const char *Name;
+    bool DoublePrecision;
+    FilterTopology Topology;
+
+    // Realtime paths get their coefficients through the designer handoff
+    // rather than designing inline.
+    bool Realtime;
+
+    // Totals for the summary; "Core" only counts the settings without
+    // bands, where legacy is the MonoChain itself, so the speedups compare
+    // like with like.
+    double Seconds {0}, CoreSeconds {0}, Samples {0}, CoreSamples {0};
+    VerifyErrors Worst;
+    int Cases {0}, Failures {0};
+};
+
+// A realtime processor is prepared at 2x oversampling and then handed the
+// case's design at 1x through DesignPendingChanges(), which publishes it the
+// way the designer thread does. The change of rate makes the first processBlock() land on the
+// handed-off coefficients from silence instead of ramping to them.
+template <typename SampleType>
+static VerifyErrors VerifyProcessor(ChannelEQAudioProcessor &processor, const ChainSettings &settings, FilterTopology topology,
+                                    const VerifySignals &signals, const VerifySignals &expected, double sampleRate, double &seconds)
+{
+    juce::MidiBuffer Midi;
+
+    SetChainSettings(processor.apvts, settings);
+    SetParameter(processor, "Topology", (float) topology);
+
+    auto Reset = [&]
+    {
+        if (processor.isNonRealtime())
+        {
+            processor.prepareToPlay(sampleRate, VerifyBlockSize);
+            return;
+        }
+
+        SetParameter(processor, "Oversampling", 1.0f);
+        processor.prepareToPlay(sampleRate, VerifyBlockSize);
+        SetParameter(processor, "Oversampling", 0.0f);
+        processor.DesignPendingChanges();
+    };
+
+    return MeasureVerifyErrors<SampleType>(signals, expected, sampleRate, Reset,
+                                           [&](juce::AudioBuffer<SampleType> &block) { processor.processBlock(block, Midi); },
+                                           seconds);
+}
+
+static void WriteVerifyRow(ResultWriter &writer, const VerifyCase &verifyCase, const VerifyPath &path, double sampleRate,
+                           const VerifyErrors &errors, double nanosecondsPerSample, bool passed)
+{
+    auto &Settings = verifyCase.Settings;
+    auto &Band = Settings.Bands[0];
+
+    writer.Begin("verify")
+          .Add("path", path.Name)
+          .Add("case", verifyCase.Name)
+          .Add("sample_rate", sampleRate)
+          .Add("low_cut_freq", Settings.LowCutFreq)
+          .Add("low_cut_slope_db_per_oct", 12 * (Settings.LowCutSlope + 1))
+          .Add("high_cut_freq", Settings.HighCutFreq)
+          .Add("high_cut_slope_db_per_oct", 12 * (Settings.HighCutSlope + 1))
+          .Add("bell_freq", Settings.BellFreq)
+          .Add("bell_gain_db", Settings.BellGainInDB)
+          .Add("bell_q", Settings.BellQ)
+          .Add("band_type", (int) Band.Type)
+          .Add("band_freq", Band.Freq)
+          .Add("band_gain_db", Band.GainInDB)
+          .Add("band_q", Band.Q)
+          .Add("magnitude_error_db", errors.MagnitudeInDB)
+          .Add("phase_error_deg", errors.PhaseInDegrees)
+          .Add("difference_db", errors.DifferenceInDB)
+          .Add("ns_per_sample", nanosecondsPerSample)
+          .Add("pass", passed ? 1 : 0)
+          .End();
+}
+
+// Returns the number of failed cases across every path.
+static int RunVerification(ResultWriter &writer, const BenchmarkOptions &options)
+{
+    std::vector<VerifyPath> Paths {
+        { "legacy",         false, FilterTopology::Biquad, false },
+        { "float",          false, FilterTopology::Biquad, false },
+        { "float_svf",      false, FilterTopology::SVF,    false },
+        { "double",         true,  FilterTopology::Biquad, false },
+        { "double_svf",     true,  FilterTopology::SVF,    false },
+        { "float_realtime", false, FilterTopology::Biquad, true }
+    };
+
+    ChannelEQAudioProcessor FloatProcessor, DoubleProcessor, RealtimeProcessor;
+    DoubleProcessor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+    // Designs happen inline, so each render starts on its final coefficients.
+    // The realtime processor is handed its designs instead, as in a host.
+    FloatProcessor.setNonRealtime(true);
+    DoubleProcessor.setNonRealtime(true);
+
+    auto Cases = MakeVerifyCases(options.VerifyGridPoints);
+
+    for (auto SampleRate : options.VerifySampleRates)
+    {
+        auto SignalLength = juce::roundToInt(options.VerifySignalSeconds * SampleRate);
+
+        for (auto &Case : Cases)
+        {
+            auto TailSamples = GetChainTailSamples(DesignChainCoefficients(Case.Settings, SampleRate, true), VerifyTailDecayInDB);
+            auto ImpulseLength = (int) juce::jlimit(4096.0, 65536.0, TailSamples);
+
+            auto Signals = MakeVerifySignals(ImpulseLength, SignalLength, SampleRate);
+            auto Expected = Signals;
+
+            ReferenceChain<double> Reference(Case.Settings, SampleRate);
+
+            for (auto *Signal : { &Expected.Impulse, &Expected.Sweep, &Expected.Noise })
+            {
+                Reference.Reset();
+                Reference.Process(Signal->getWritePointer(0), Signal->getNumSamples());
+            }
+
+            auto Core = ! HasBands(Case.Settings);
+            VerifyErrors LegacyErrors;
+
+            for (auto &Path : Paths)
+            {
+                auto IsLegacy = &Path == &Paths.front();
+                double Seconds = 0;
+                VerifyErrors Errors;
+
+                if (IsLegacy && Core)
+                {
+                    MonoChain LeftChain, RightChain;
+                    juce::dsp::ProcessSpec Spec {SampleRate, (juce::uint32) VerifyBlockSize, 1};
+                    LeftChain.prepare(Spec);
+                    RightChain.prepare(Spec);
+                    ConfigureLegacyChain(LeftChain, Case.Settings, SampleRate);
+                    ConfigureLegacyChain(RightChain, Case.Settings, SampleRate);
+
+                    Errors = MeasureVerifyErrors<float>(Signals, Expected, SampleRate,
+                                                        [&] { LeftChain.reset(); RightChain.reset(); },
+                                                        [&](juce::AudioBuffer<float> &block)
+                                                        {
+                                                            juce::dsp::AudioBlock<float> Audio(block);
+                                                            auto LeftBlock = Audio.getSingleChannelBlock(0);
+                                                            auto RightBlock = Audio.getSingleChannelBlock(1);
+                                                            LeftChain.process(juce::dsp::ProcessContextReplacing<float>(LeftBlock));
+                                                            RightChain.process(juce::dsp::ProcessContextReplacing<float>(RightBlock));
+                                                        },
+                                                        Seconds);
+                }
+                else if (IsLegacy)
+                {
+                    ReferenceChain<float> LeftChain(Case.Settings, SampleRate), RightChain(Case.Settings, SampleRate);
+
+                    Errors = MeasureVerifyErrors<float>(Signals, Expected, SampleRate,
+                                                        [&] { LeftChain.Reset(); RightChain.Reset(); },
+                                                        [&](juce::AudioBuffer<float> &block)
+                                                        {
+                                                            LeftChain.Process(block.getWritePointer(0), block.getNumSamples());
+                                                            RightChain.Process(block.getWritePointer(1), block.getNumSamples());
+                                                        },
+                                                        Seconds);
+                }
+                else if (Path.DoublePrecision)
+                {
+                    Errors = VerifyProcessor<double>(DoubleProcessor, Case.Settings, Path.Topology, Signals, Expected, SampleRate, Seconds);
+                }
+                else
+                {
+                    Errors = VerifyProcessor<float>(Path.Realtime ? RealtimeProcessor : FloatProcessor, Case.Settings, Path.Topology,
+                                                    Signals, Expected, SampleRate, Seconds);
+                }
+
+                if (IsLegacy)
+                    LegacyErrors = Errors;
+
+                auto Allowed = Path.DoublePrecision ? DoubleTolerances
+                                                    : GetAllowedErrors(FloatTolerances, IsLegacy ? nullptr : &LegacyErrors);
+
+                // The legacy chain is the baseline, recorded but never failed.
+                auto Passed = IsLegacy || IsWithin(Errors, Allowed);
+
+                // Only the sweep and the noise are timed.
+                auto NumSamples = 2.0 * SignalLength;
+
+                Path.Seconds += Seconds;
+                Path.Samples += NumSamples;
+
+                if (Core)
+                {
+                    Path.CoreSeconds += Seconds;
+                    Path.CoreSamples += NumSamples;
+                }
+
+                Path.Worst.MagnitudeInDB = juce::jmax(Path.Worst.MagnitudeInDB, Errors.MagnitudeInDB);
+                Path.Worst.PhaseInDegrees = juce::jmax(Path.Worst.PhaseInDegrees, Errors.PhaseInDegrees);
+                Path.Worst.DifferenceInDB = juce::jmax(Path.Worst.DifferenceInDB, Errors.DifferenceInDB);
+                Path.Cases += 1;
+                Path.Failures += Passed ? 0 : 1;
+
+                WriteVerifyRow(writer, Case, Path, SampleRate, Errors, Seconds * 1.0e9 / NumSamples, Passed);
+            }
+        }
+    }
+
+    auto &Legacy = Paths.front();
+    auto LegacyNanoseconds = Legacy.CoreSeconds * 1.0e9 / juce::jmax(1.0, Legacy.CoreSamples);
+    auto Failures = 0;
+
+    for (auto &Path : Paths)
+    {
+        auto CoreNanoseconds = Path.CoreSeconds * 1.0e9 / juce::jmax(1.0, Path.CoreSamples);
+
+        writer.Begin("verify_summary")
+              .Add("path", Path.Name)
+              .Add("cases", Path.Cases)
+              .Add("failures", Path.Failures)
+              .Add("worst_magnitude_error_db", Path.Worst.MagnitudeInDB)
+              .Add("worst_phase_error_deg", Path.Worst.PhaseInDegrees)
+              .Add("worst_difference_db", Path.Worst.DifferenceInDB)
+              .Add("ns_per_sample", Path.Seconds * 1.0e9 / juce::jmax(1.0, Path.Samples))
+              .Add("speedup_vs_legacy", CoreNanoseconds > 0.0 ? LegacyNanoseconds / CoreNanoseconds : 0.0)
+              .End();
+
+        Failures += Path.Failures;
+    }
+
+    return Failures;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Initialiser;
+
+    BenchmarkOptions Options;
+    std::ofstream OutputFile;
+    auto Verify = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String Argument(argv[i]);
+
+        if (Argument == "--quick")
+        {
+            Options.SamplesPerConfiguration = 1 << 16;
+            Options.DesignIterations = 200;
+            Options.ConsoleBlocks = 200;
+            Options.VerifyGridPoints = 3;
+            Options.VerifySignalSeconds = 0.1;
+            Options.VerifySampleRates = { 48000.0 };
+        }
+        else if (Argument == "--verify")
+        {
+            Verify = true;
+        }
+        else if (Argument == "--output" && i + 1 < argc)
+        {
+            OutputFile.open(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "usage: ChannelEQBenchmark [--quick] [--verify] [--output results.jsonl]" << std::endl;
+            return 1;
+        }
+    }
+
+    ResultWriter Writer(OutputFile.is_open() ? OutputFile : std::cout);
+
+    if (Verify)
+        return RunVerification(Writer, Options) == 0 ? 0 : 1;
+
+    const double SampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const int BlockSizes[] = { 16, 64, 256, 1024, 4096 };
+    const Slope Slopes[] = { Slope_12, Slope_24, Slope_36, Slope_48, Slope_60 };
+
+    for (auto SampleRate : SampleRates)
+        for (auto BlockSize : BlockSizes)
+            for (auto SlopeSetting : Slopes)
+                for (auto Automated : { false, true })
+                    RunProcessBenchmark(Writer, Options, SampleRate, BlockSize, SlopeSetting, Automated);
+
+    for (auto BlockSize : BlockSizes)
+        for (auto SlopeSetting : Slopes)
+            RunProcessBenchmark(Writer, Options, 48000.0, BlockSize, SlopeSetting, true, 0, FilterTopology::Biquad, true);
+
+    for (auto SampleRate : { 48000.0, 96000.0 })
+        for (auto BlockSize : { 64, 256 })
+            for (auto SlopeSetting : Slopes)
+                for (auto Automated : { false, true })
+                    RunProcessBenchmark(Writer, Options, SampleRate, BlockSize, SlopeSetting, Automated, 0, FilterTopology::SVF);
+
+    for (auto SampleRate : { 48000.0, 192000.0 })
+        for (auto SlopeSetting : Slopes)
+            for (auto Topology : { FilterTopology::Biquad, FilterTopology::SVF })
+                RunProcessBenchmark<double>(Writer, Options, SampleRate, 256, SlopeSetting, false, 0, Topology);
+
+    for (auto BlockSize : { 64, 256, 1024 })
+        for (auto SlopeSetting : Slopes)
+            RunCascadeBenchmark(Writer, Options, 48000.0, BlockSize, SlopeSetting);
+
+    for (int NumBands = 0; NumBands <= ChainSettings::MaxBands; NumBands += 2)
+        RunCascadeBenchmark(Writer, Options, 48000.0, 256, Slope_24, NumBands);
+
+    for (auto Topology : { FilterTopology::Biquad, FilterTopology::SVF })
+        for (auto BlockSize : { 64, 256, 1024 })
+            RunDynamicBellBenchmark(Writer, Options, 48000.0, BlockSize, Topology);
+
+    for (auto Topology : { FilterTopology::Biquad, FilterTopology::SVF })
+        for (auto BlockSize : { 64, 256, 1024 })
+            RunMidSideBenchmark(Writer, Options, 48000.0, BlockSize, Topology);
+
+    for (auto BlockSize : { 64, 256, 1024 })
+        RunProgramChangeBenchmark(Writer, Options, 48000.0, BlockSize);
+
+    for (auto SampleRate : { 44100.0, 48000.0, 96000.0 })
+        for (int Order = 1; Order <= ChannelEQAudioProcessor::MaxOversamplingOrder; ++Order)
+            for (auto Automated : { false, true })
+                RunProcessBenchmark(Writer, Options, SampleRate, 256, Slope_24, Automated, Order);
+
+    for (auto KernelLength : { 4096, 8192, 16384 })
+        for (auto PartitionSize : { 128, 512, 2048 })
+            RunLinearPhaseBenchmark(Writer, Options, 48000.0, 256, KernelLength, PartitionSize);
+
+    for (auto BlockSize : { 64, 256, 1024 })
+        RunAnalyzerTapBenchmark(Writer, Options, 48000.0, BlockSize);
+
+    for (auto SampleRate : SampleRates)
+        for (auto SlopeSetting : Slopes)
+            RunDesignBenchmark(Writer, Options, SampleRate, SlopeSetting);
+
+    for (auto NumStrips : { 32, 64, 128 })
+        RunConsoleBenchmark(Writer, Options, NumStrips, 48000.0, 256);
+
+    auto CacheStatistics = juce::SharedResourcePointer<CoefficientCache>()->GetStatistics();
+
+    Writer.Begin("coefficient_cache")
+          .Add("hits", (double) CacheStatistics.Hits)
+          .Add("misses", (double) CacheStatistics.Misses)
+          .Add("evictions", (double) CacheStatistics.Evictions)
+          .Add("size", (double) CacheStatistics.Size)
+          .End();
+
+    return 0;
+}